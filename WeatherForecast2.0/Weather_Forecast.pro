@@ -1,4 +1,4 @@
-QT       += core gui network
+QT       += core gui network concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -16,14 +16,57 @@ DEFINES += QT_DEPRECATED_WARNINGS
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    appconfig.cpp \
+    assetpack.cpp \
     citycodeutils.cpp \
+    citydatareader.cpp \
+    citydelta.cpp \
+    cityindexmanager.cpp \
     day.cpp \
+    forecastdate.cpp \
+    forecastdiff.cpp \
+    forecastcache.cpp \
+    forecastparser.cpp \
+    forecastrecord.cpp \
+    forecastschema.cpp \
+    forecaststore.cpp \
+    geoindex.cpp \
+    jsonscan.cpp \
+    lazyforecast.cpp \
     main.cpp \
+    parsearena.cpp \
+    searchdispatcher.cpp \
+    searchhistory.cpp \
+    singleinstance.cpp \
+    startupoptions.cpp \
+    weathertables.cpp \
     widget.cpp
 
 HEADERS += \
+    appconfig.h \
+    assetpack.h \
     citycodeutils.h \
+    citydatareader.h \
+    citydelta.h \
+    cityindexmanager.h \
     day.h \
+    forecastdate.h \
+    forecastdiff.h \
+    forecastcache.h \
+    forecastparser.h \
+    forecastrecord.h \
+    forecastschema.h \
+    forecaststore.h \
+    geoindex.h \
+    jsonscan.h \
+    lazyforecast.h \
+    parsearena.h \
+    recordpool.h \
+    searchdispatcher.h \
+    searchhistory.h \
+    singleinstance.h \
+    startupoptions.h \
+    weathertables.h \
     widget.h
 
 FORMS += \
@@ -34,10 +77,39 @@ qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
 !isEmpty(target.path): INSTALLS += target
 
-RESOURCES += \
-    citycode.qrc \
-    res.qrc \
-    res.qrc \
-    res.qrc \
-    res.qrc \
-    res.qrc
+# 资源压缩：仅在压缩能节省20%以上时保存压缩数据。
+# PNG图标本身已压缩，按原样存储以免加载时白白解压；
+# citycode.qrc中的城市数据单独指定了最高压缩级别。
+# 各资源的打包体积可用 tools/resource_report.py 查看。
+QMAKE_RESOURCE_FLAGS += -compress 9 -threshold 20
+
+# 外部资源包：使用 qmake CONFIG+=external_assets 构建时，图标和城市数据
+# 不再编译进可执行文件，而是生成与可执行文件同目录的WeatherForecast.rcc，
+# 启动时由AssetPack内存映射后注册。
+external_assets {
+    DEFINES += WEATHER_EXTERNAL_ASSETS
+
+    win32:CONFIG(debug, debug|release): ASSET_PACK_DIR = $$OUT_PWD/debug
+    else:win32: ASSET_PACK_DIR = $$OUT_PWD/release
+    else: ASSET_PACK_DIR = $$OUT_PWD
+
+    assetpack.target = $$ASSET_PACK_DIR/WeatherForecast.rcc
+    assetpack.depends = $$PWD/res.qrc $$PWD/citycode.qrc $$PWD/citycode.min.json $$PWD/cityalias.csv
+    assetpack.commands = $$shell_path($$[QT_HOST_BINS]/rcc) -binary $$QMAKE_RESOURCE_FLAGS \
+        $$shell_path($$PWD/res.qrc) $$shell_path($$PWD/citycode.qrc) \
+        -o $$shell_path($$assetpack.target)
+    QMAKE_EXTRA_TARGETS += assetpack
+    PRE_TARGETDEPS += $$assetpack.target
+
+    # 部署时资源包与可执行文件安装到同一目录
+    !isEmpty(target.path) {
+        assetpack_install.files = $$assetpack.target
+        assetpack_install.path = $$target.path
+        assetpack_install.CONFIG += no_check_exist
+        INSTALLS += assetpack_install
+    }
+} else {
+    RESOURCES += \
+        citycode.qrc \
+        res.qrc
+}
@@ -0,0 +1,268 @@
+/**
+ * @file appconfig.cpp
+ * @brief 应用程序配置子系统的实现文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 该文件实现了配置文件的读取、校验，以及基于文件监视的热加载功能。
+ */
+
+#include "appconfig.h"        // 配置子系统头文件
+#include "forecastschema.h"   // 支持的API版本
+
+#include <QDebug>             // 调试输出
+#include <QFileInfo>          // 文件路径信息
+#include <QFileSystemWatcher> // 文件变化监视
+#include <QMutexLocker>       // 互斥锁自动加解锁
+#include <QRegularExpression> // 版本号格式校验
+#include <QSettings>          // INI配置文件读取
+#include <QTimer>             // 防抖定时器
+#include <QUrl>               // URL格式校验
+#include <QUrlQuery>          // 请求参数编码
+#include <QtConcurrent>       // 后台线程执行解析任务
+
+// 修改通知的防抖间隔（毫秒），编辑器保存文件时往往会连续触发多次通知
+static const int kReloadDebounceMs = 300;
+
+AppConfig::AppConfig()
+    : apiAppId("29132936")
+    , apiAppSecret("JV3FYmaV")
+    , apiBaseUrl("http://gfeljm.tianqiapi.com/api")
+    , apiVersion("v9")
+    , cacheTtlSeconds(600)
+    , refreshMode("off")
+    , refreshForecastSeconds(3600)
+    , refreshCurrentSeconds(600)
+    , currentVersion("v61")
+{
+}
+
+AppConfig AppConfig::fromFile(const QString &configPath)
+{
+    AppConfig config;
+
+    // 创建QSettings对象读取INI格式配置文件
+    QSettings settings(configPath, QSettings::IniFormat);
+
+    // 读取API配置信息，如果配置项不存在则使用默认值
+    settings.beginGroup("API");
+    config.apiAppId = settings.value("appid", config.apiAppId).toString().trimmed();
+    config.apiAppSecret = settings.value("appsecret", config.apiAppSecret).toString().trimmed();
+    config.apiBaseUrl = settings.value("base_url", config.apiBaseUrl).toString().trimmed();
+    config.apiVersion = settings.value("version", config.apiVersion).toString().trimmed();
+    settings.endGroup();
+
+    // 读取缓存配置，无法解析为整数时置为-1，由validate报告错误
+    settings.beginGroup("Cache");
+    bool ok = false;
+    config.cacheTtlSeconds = settings.value("ttl", config.cacheTtlSeconds).toInt(&ok);
+    if(!ok)
+    {
+        config.cacheTtlSeconds = -1;
+    }
+    settings.endGroup();
+
+    // 读取定时刷新配置，间隔无法解析为整数时同样置为-1
+    settings.beginGroup("Refresh");
+    config.refreshMode = settings.value("mode", config.refreshMode).toString().trimmed();
+    config.refreshForecastSeconds = settings.value("forecast", config.refreshForecastSeconds).toInt(&ok);
+    if(!ok)
+    {
+        config.refreshForecastSeconds = -1;
+    }
+    config.refreshCurrentSeconds = settings.value("current", config.refreshCurrentSeconds).toInt(&ok);
+    if(!ok)
+    {
+        config.refreshCurrentSeconds = -1;
+    }
+    config.currentVersion = settings.value("current_version", config.currentVersion).toString().trimmed();
+    settings.endGroup();
+
+    return config;
+}
+
+bool AppConfig::validate(QString *errorMessage) const
+{
+    QString error;
+
+    // 基础URL必须是完整的http或https地址
+    QUrl baseUrl(apiBaseUrl, QUrl::StrictMode);
+    if(!baseUrl.isValid() || baseUrl.host().isEmpty()
+            || (baseUrl.scheme() != "http" && baseUrl.scheme() != "https"))
+    {
+        error = QString("base_url无效: %1").arg(apiBaseUrl);
+    }
+    else if(apiAppId.isEmpty() || apiAppSecret.isEmpty())
+    {
+        error = "appid和appsecret不能为空";
+    }
+    else if(!QRegularExpression("^v[0-9]+$").match(apiVersion).hasMatch())
+    {
+        error = QString("version格式无效: %1").arg(apiVersion);
+    }
+    else if(!ForecastSchema::find(apiVersion))
+    {
+        // 没有对应的响应格式就无法解析该版本的响应
+        error = QString("不支持的version: %1（支持: %2）").arg(apiVersion, ForecastSchema::supportedVersions());
+    }
+    else if(cacheTtlSeconds < 0)
+    {
+        error = "Cache/ttl必须是非负整数";
+    }
+    else if(refreshMode != "off" && refreshMode != "full" && refreshMode != "tiered")
+    {
+        error = QString("Refresh/mode无效: %1（可选: off, full, tiered）").arg(refreshMode);
+    }
+    else if(refreshMode != "off" && refreshForecastSeconds <= 0)
+    {
+        error = "Refresh/forecast必须是正整数";
+    }
+    else if(refreshMode == "tiered" && refreshCurrentSeconds <= 0)
+    {
+        error = "Refresh/current必须是正整数";
+    }
+    else if(refreshMode == "tiered" && !ForecastSchema::find(currentVersion))
+    {
+        error = QString("不支持的Refresh/current_version: %1（支持: %2）")
+                .arg(currentVersion, ForecastSchema::supportedVersions());
+    }
+
+    if(errorMessage)
+    {
+        *errorMessage = error;
+    }
+    return error.isEmpty();
+}
+
+QString AppConfig::apiUrl(const QString &cityCode, const QString &version) const
+{
+    // 根据配置中的参数构建完整的API请求URL；
+    // 每个参数值都由QUrlQuery编码，值中的'&'、'='不会变成额外的参数
+    QUrlQuery query;
+    query.addQueryItem("unescape", "1");
+    query.addQueryItem("version", version.isEmpty() ? apiVersion : version);
+    query.addQueryItem("appid", apiAppId);
+    query.addQueryItem("appsecret", apiAppSecret);
+    if(!cityCode.isEmpty())
+    {
+        query.addQueryItem("cityid", cityCode);
+    }
+    QUrl url(apiBaseUrl);
+    url.setQuery(query);
+    return url.toString(QUrl::FullyEncoded);
+}
+
+bool AppConfig::operator==(const AppConfig &other) const
+{
+    return apiAppId == other.apiAppId
+            && apiAppSecret == other.apiAppSecret
+            && apiBaseUrl == other.apiBaseUrl
+            && apiVersion == other.apiVersion
+            && cacheTtlSeconds == other.cacheTtlSeconds
+            && refreshMode == other.refreshMode
+            && refreshForecastSeconds == other.refreshForecastSeconds
+            && refreshCurrentSeconds == other.refreshCurrentSeconds
+            && currentVersion == other.currentVersion;
+}
+
+ConfigManager::ConfigManager(const QString &configPath, QObject *parent)
+    : QObject(parent)
+    , mConfigPath(configPath)
+    , mWatcher(new QFileSystemWatcher(this))
+    , mDebounceTimer(new QTimer(this))
+    , mReloadPending(false)
+{
+    // 启动时同步加载一次，首个网络请求需要立即使用配置
+    AppConfig config = AppConfig::fromFile(mConfigPath);
+    QString error;
+    if(!config.validate(&error))
+    {
+        qWarning() << "配置文件无效，使用默认配置:" << error;
+        config = AppConfig();
+    }
+    mSnapshot = AppConfigSnapshot(new AppConfig(config));
+
+    mDebounceTimer->setSingleShot(true);
+    mDebounceTimer->setInterval(kReloadDebounceMs);
+    connect(mDebounceTimer, &QTimer::timeout, this, &ConfigManager::startReload);
+
+    // 同时监视文件本身和所在目录，目录通知用于捕获文件的创建和替换
+    connect(mWatcher, &QFileSystemWatcher::fileChanged, this, &ConfigManager::onFileChanged);
+    connect(mWatcher, &QFileSystemWatcher::directoryChanged, this, &ConfigManager::onFileChanged);
+    connect(&mReloadWatcher, &QFutureWatcher<AppConfig>::finished, this, &ConfigManager::onReloadFinished);
+    rewatch();
+}
+
+AppConfigSnapshot ConfigManager::snapshot() const
+{
+    QMutexLocker locker(&mMutex);
+    return mSnapshot;
+}
+
+QString ConfigManager::configPath() const
+{
+    return mConfigPath;
+}
+
+void ConfigManager::onFileChanged()
+{
+    rewatch();
+    mDebounceTimer->start();
+}
+
+void ConfigManager::startReload()
+{
+    // 上一次解析尚未完成时只做标记，完成后再解析一次
+    if(mReloadWatcher.isRunning())
+    {
+        mReloadPending = true;
+        return;
+    }
+    mReloadWatcher.setFuture(QtConcurrent::run(&AppConfig::fromFile, mConfigPath));
+}
+
+void ConfigManager::onReloadFinished()
+{
+    AppConfig config = mReloadWatcher.result();
+
+    QString error;
+    if(!config.validate(&error))
+    {
+        // 校验失败时保留当前配置，避免一次错误的编辑中断服务
+        qWarning() << "配置文件无效，保留当前配置:" << error;
+    }
+    else
+    {
+        AppConfigSnapshot newSnapshot(new AppConfig(config));
+        AppConfigSnapshot oldSnapshot = snapshot();
+
+        // 内容没有变化时不替换，也不通知使用者
+        if(config != *oldSnapshot)
+        {
+            {
+                QMutexLocker locker(&mMutex);
+                mSnapshot = newSnapshot;
+            }
+            emit configChanged(newSnapshot);
+        }
+    }
+
+    if(mReloadPending)
+    {
+        mReloadPending = false;
+        startReload();
+    }
+}
+
+void ConfigManager::rewatch()
+{
+    QString dirPath = QFileInfo(mConfigPath).absolutePath();
+    if(!mWatcher->directories().contains(dirPath))
+    {
+        mWatcher->addPath(dirPath);
+    }
+    if(QFileInfo::exists(mConfigPath) && !mWatcher->files().contains(mConfigPath))
+    {
+        mWatcher->addPath(mConfigPath);
+    }
+}
@@ -0,0 +1,167 @@
+/**
+ * @file appconfig.h
+ * @brief 应用程序配置子系统的头文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 该文件定义了AppConfig不可变配置快照类和ConfigManager配置管理类。
+ * ConfigManager通过QFileSystemWatcher监视config.ini，在后台线程中解析、
+ * 校验新的配置，并以原子方式替换当前的配置快照，使应用程序无需重启即可
+ * 使用新的API密钥、基础URL等设置。
+ */
+
+#ifndef APPCONFIG_H
+#define APPCONFIG_H
+
+#include <QObject>              // Qt对象基类
+#include <QString>              // Qt字符串类
+#include <QSharedPointer>       // 引用计数智能指针，用于共享配置快照
+#include <QMutex>               // 互斥锁，保护快照指针的替换
+#include <QFutureWatcher>       // 监视后台解析任务的完成
+
+class QFileSystemWatcher;
+class QTimer;
+
+/**
+ * @class AppConfig
+ * @brief 不可变的配置快照
+ *
+ * 一个AppConfig对象构建完成后不再修改，可以被任意线程安全地共享读取。
+ * 配置更新时总是构建新的对象并整体替换，而不是修改已有对象。
+ */
+class AppConfig
+{
+public:
+    /**
+     * @brief 默认构造函数
+     *
+     * 使用内置的默认API配置创建快照，在配置文件不存在时使用。
+     */
+    AppConfig();
+
+    /**
+     * @brief 从INI配置文件读取配置
+     * @param configPath 配置文件路径
+     * @return 读取到的配置，缺失的项使用默认值
+     *
+     * 该函数只使用可重入的QSettings，可以在后台线程中调用。
+     */
+    static AppConfig fromFile(const QString &configPath);
+
+    /**
+     * @brief 校验配置的有效性
+     * @param errorMessage 校验失败时写入失败原因，可为nullptr
+     * @return true表示配置有效
+     */
+    bool validate(QString *errorMessage = nullptr) const;
+
+    /**
+     * @brief 构建天气API请求URL
+     * @param cityCode 城市代码，为空时请求服务器默认城市
+     * @param version API版本，为空时使用apiVersion
+     * @return 完整的API请求URL字符串
+     */
+    QString apiUrl(const QString &cityCode = QString(), const QString &version = QString()) const;
+
+    /**
+     * @brief 比较两份配置的内容是否相同
+     */
+    bool operator==(const AppConfig &other) const;
+    bool operator!=(const AppConfig &other) const { return !(*this == other); }
+
+    QString apiAppId;       // API应用ID
+    QString apiAppSecret;   // API密钥
+    QString apiBaseUrl;     // API基础URL
+    QString apiVersion;     // API版本，必须是ForecastSchema支持的版本
+    int cacheTtlSeconds;    // 天气数据缓存的有效期（秒）
+    QString refreshMode;    // 定时刷新模式：off不刷新（默认），full只刷新完整预报，tiered同时频繁刷新当天实况
+    int refreshForecastSeconds; // 完整预报的刷新间隔（秒）
+    int refreshCurrentSeconds;  // tiered模式下当天实况的刷新间隔（秒）
+    QString currentVersion; // tiered模式下当天实况使用的API版本，响应只有当天的数据
+};
+
+/**
+ * @brief 配置快照类型
+ *
+ * 指向不可变配置对象的共享指针，持有者在替换发生后仍可安全使用旧快照。
+ */
+typedef QSharedPointer<const AppConfig> AppConfigSnapshot;
+
+/**
+ * @class ConfigManager
+ * @brief 支持热加载的配置管理类
+ *
+ * 主要功能：
+ * - 启动时同步加载一次配置，保证首个请求即可使用
+ * - 监视配置文件的修改、替换和创建
+ * - 合并短时间内的多次修改通知，避免重复解析
+ * - 在后台线程解析并校验新配置，校验失败时保留原配置
+ * - 以原子方式替换配置快照并发出configChanged信号
+ */
+class ConfigManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造函数
+     * @param configPath 配置文件路径
+     * @param parent 父对象指针
+     */
+    explicit ConfigManager(const QString &configPath, QObject *parent = nullptr);
+
+    /**
+     * @brief 获取当前配置快照
+     * @return 当前生效的配置快照，可在任意线程调用
+     */
+    AppConfigSnapshot snapshot() const;
+
+    /**
+     * @brief 获取配置文件路径
+     */
+    QString configPath() const;
+
+signals:
+    /**
+     * @brief 配置快照被替换后发出
+     * @param config 新的配置快照
+     */
+    void configChanged(AppConfigSnapshot config);
+
+private slots:
+    /**
+     * @brief 配置文件或其所在目录发生变化
+     *
+     * 重新启动防抖定时器，等待编辑器完成写入后再解析。
+     */
+    void onFileChanged();
+
+    /**
+     * @brief 防抖定时器到期，启动后台解析任务
+     */
+    void startReload();
+
+    /**
+     * @brief 后台解析任务完成，校验并替换快照
+     */
+    void onReloadFinished();
+
+private:
+    /**
+     * @brief 将配置文件重新加入监视列表
+     *
+     * 许多编辑器通过"写临时文件再重命名"的方式保存文件，
+     * 这会使QFileSystemWatcher丢失对原文件的监视，需要重新添加。
+     */
+    void rewatch();
+
+    QString mConfigPath;                        // 配置文件路径
+    mutable QMutex mMutex;                      // 保护mSnapshot的读写
+    AppConfigSnapshot mSnapshot;                // 当前生效的配置快照
+    QFileSystemWatcher *mWatcher;               // 文件监视器
+    QTimer *mDebounceTimer;                     // 修改通知防抖定时器
+    QFutureWatcher<AppConfig> mReloadWatcher;   // 后台解析任务监视器
+    bool mReloadPending;                        // 解析期间是否又收到了修改通知
+};
+
+#endif // APPCONFIG_H
@@ -0,0 +1,72 @@
+/**
+ * @file assetpack.cpp
+ * @brief 外部资源包加载类的实现文件
+ * @author Weather Forecast Team
+ * @date 2025
+ */
+
+#include "assetpack.h"        // 外部资源包加载类头文件
+
+#include <QCoreApplication>   // 获取可执行文件路径
+#include <QDebug>             // 调试输出
+#include <QResource>          // 资源注册
+
+AssetPack::AssetPack()
+    : mData(nullptr)
+{
+}
+
+AssetPack::~AssetPack()
+{
+    if(mData)
+    {
+        QResource::unregisterResource(mData);
+        mFile.unmap(mData);
+    }
+}
+
+bool AssetPack::mount(const QString &path)
+{
+    if(mData)
+    {
+        return true;
+    }
+
+    mFile.setFileName(path);
+    if(!mFile.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "无法打开资源包:" << path << mFile.errorString();
+        return false;
+    }
+
+    // 映射整个文件，此时并不读取数据，页面在首次访问时才载入
+    uchar *data = mFile.map(0, mFile.size());
+    if(!data)
+    {
+        qWarning() << "无法映射资源包:" << path << mFile.errorString();
+        mFile.close();
+        return false;
+    }
+
+    // 注册文件头中的资源索引，校验失败说明不是rcc生成的资源包
+    if(!QResource::registerResource(data))
+    {
+        qWarning() << "资源包格式无效:" << path;
+        mFile.unmap(data);
+        mFile.close();
+        return false;
+    }
+
+    mData = data;
+    return true;
+}
+
+bool AssetPack::isMounted() const
+{
+    return mData != nullptr;
+}
+
+QString AssetPack::defaultPath()
+{
+    return QCoreApplication::applicationDirPath() + "/WeatherForecast.rcc";
+}
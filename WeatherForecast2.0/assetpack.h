@@ -0,0 +1,67 @@
+/**
+ * @file assetpack.h
+ * @brief 外部资源包加载类的头文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 该文件定义了AssetPack类，用于挂载外部的二进制资源包。
+ * 资源包由rcc -binary从res.qrc和citycode.qrc生成，文件头中包含资源目录树索引。
+ * 挂载时只做内存映射并注册索引，图标和城市数据在首次访问时才由操作系统
+ * 按页载入，不再编译进可执行文件。
+ */
+
+#ifndef ASSETPACK_H
+#define ASSETPACK_H
+
+#include <QFile>            // 资源包文件及其内存映射
+#include <QString>          // Qt字符串类
+
+/**
+ * @class AssetPack
+ * @brief 内存映射的外部资源包
+ *
+ * 挂载成功后，资源包中的文件可以像编译进程序的资源一样通过":/..."路径访问。
+ * AssetPack对象析构时注销资源并解除映射，因此其生命周期必须覆盖所有资源的使用。
+ */
+class AssetPack
+{
+public:
+    /**
+     * @brief 默认构造函数，创建未挂载的资源包
+     */
+    AssetPack();
+
+    /**
+     * @brief 析构函数，注销资源并解除内存映射
+     */
+    ~AssetPack();
+
+    /**
+     * @brief 挂载资源包
+     * @param path 资源包文件路径
+     * @return 挂载是否成功
+     *
+     * 只映射文件并注册文件头中的索引，不读取资源数据。
+     */
+    bool mount(const QString &path);
+
+    /**
+     * @brief 资源包是否已挂载
+     */
+    bool isMounted() const;
+
+    /**
+     * @brief 获取默认的资源包路径（可执行文件同目录下的WeatherForecast.rcc）
+     */
+    static QString defaultPath();
+
+private:
+    // 禁止拷贝，映射内存只能由一个对象负责释放
+    AssetPack(const AssetPack &);
+    AssetPack &operator=(const AssetPack &);
+
+    QFile mFile;        // 资源包文件，映射期间必须保持打开
+    uchar *mData;       // 映射后的资源包数据，未挂载时为nullptr
+};
+
+#endif // ASSETPACK_H
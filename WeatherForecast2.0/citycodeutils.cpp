@@ -11,20 +11,392 @@
 
 #include "citycodeutils.h"    // 城市代码工具类头文件
 
+#include "citydatareader.h"   // 城市数据流式读取
+
+#include <QDebug>             // 调试输出
+#include <QElapsedTimer>      // 建立索引耗时统计
 #include <QFile>              // Qt文件操作类
-#include <QJsonArray>         // Qt JSON数组类
-#include <QJsonDocument>      // Qt JSON文档处理类
+#include <QHash>              // qHashBits，建立索引时记录编号到下标的映射
+#include <QPair>              // 并行任务的下标范围
+#include <QThread>            // CPU核心数
+#include <QVarLengthArray>    // 查询时折叠名称的栈上缓冲区
+#include <QtConcurrent>       // 并行计算词干和排序
+#include <QtNumeric>          // qIsNaN，缺失坐标
+
+#include <algorithm>          // std::sort、std::inplace_merge、std::lower_bound，索引排序和前缀查找
+#include <cstring>            // memcmp、strlen，UTF-8片段比较
 
 /**
  * @brief CityCodeUtils类的构造函数
  * 
- * 创建CityCodeUtils实例。城市映射表采用延迟初始化策略，
- * 即在首次调用getCityCodeFromName函数时才会加载城市数据，
- * 以提高应用程序启动速度。
+ * 创建空的CityCodeUtils实例。应用程序中由CityIndexManager在后台线程
+ * 加载城市数据并建立索引，以提高应用程序启动速度。
  */
 CityCodeUtils::CityCodeUtils()
 {
-    // 构造函数为空，城市数据将在首次使用时延迟加载
+    // 构造函数为空，城市数据由InitCityMap或build加载
+}
+
+int CityCodeUtils::cityCount() const
+{
+    return mCities.size();
+}
+
+/**
+ * @brief 行政区划后缀表
+ * 
+ * 按长度从长到短排列，保证"自治州"优先于"州"类的短后缀被匹配。
+ * 不包含单独的"州"，"广州"、"杭州"等城市名称本身以"州"结尾。
+ */
+static const char *const kAdminSuffixes[] = {
+    "特别行政区",
+    "自治州", "自治县", "自治旗", "自治区",
+    "地区", "新区", "林区", "矿区", "特区",
+    "市", "县", "区", "旗", "盟", "省",
+};
+
+/**
+ * @brief 民族名称表
+ * 
+ * 用于从自治地方的词干中去掉民族名称，如"江华瑶族"→"江华"。
+ * 各民族名称互不为后缀，匹配顺序不影响结果。
+ */
+static const char *const kEthnicNames[] = {
+    "塔吉克族", "乌孜别克族", "俄罗斯族", "鄂温克族", "鄂伦春族", "哈萨克族",
+    "柯尔克孜族", "塔塔尔族", "达斡尔族", "高山族", "纳西族", "景颇族",
+    "傈僳族", "东乡族", "仫佬族", "布朗族", "撒拉族", "毛南族", "仡佬族",
+    "阿昌族", "普米族", "怒族", "德昂族", "保安族", "裕固族", "门巴族",
+    "珞巴族", "基诺族", "赫哲族", "独龙族", "京族", "蒙古族", "朝鲜族",
+    "维吾尔族", "土家族", "哈尼族", "拉祜族", "佤族", "畲族", "水族",
+    "羌族", "土族", "锡伯族", "回族", "藏族", "苗族", "彝族", "壮族",
+    "布依族", "侗族", "瑶族", "白族", "傣族", "黎族", "满族",
+};
+
+// 去掉后缀后词干至少保留的字数
+static const int kMinStemLength = 2;
+
+/**
+ * @brief 去掉名称结尾的一个后缀
+ * @param name 名称
+ * @param suffixes 后缀表
+ * @param count 后缀数量
+ * @return 去掉后缀的名称，没有匹配的后缀时返回空字符串
+ */
+static QString stripSuffix(const QString &name, const char *const *suffixes, int count)
+{
+    for(int i = 0; i < count; i++)
+    {
+        QString suffix = QString::fromUtf8(suffixes[i]);
+        if(name.endsWith(suffix) && name.length() - suffix.length() >= kMinStemLength)
+        {
+            return name.left(name.length() - suffix.length());
+        }
+    }
+    return QString();
+}
+
+/**
+ * @brief 名称折叠表
+ * 
+ * ASCII字符的折叠结果：英文字母转为小写，空白、连字符、撇号、点和下划线
+ * 映射为0表示去掉，其余字符不变。建立索引和查询使用同一张表，
+ * 用户输入"Hong Kong"、"hongkong"、"ＨＯＮＧ－ＫＯＮＧ"都折叠为同一个键。
+ */
+struct NameFoldTable
+{
+    char map[128];          // ASCII字符的折叠结果，0表示去掉
+
+    NameFoldTable()
+    {
+        for(int c = 0; c < 128; c++)
+        {
+            map[c] = static_cast<char>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+        }
+        const char dropped[] = " \t-'._";
+        for(int i = 0; dropped[i] != '\0'; i++)
+        {
+            map[static_cast<int>(dropped[i])] = 0;
+        }
+    }
+};
+
+static const NameFoldTable &nameFoldTable()
+{
+    // 局部静态变量的初始化是线程安全的，后台建立索引和界面查询可以同时使用
+    static const NameFoldTable table;
+    return table;
+}
+
+/**
+ * @brief 折叠UTF-8名称
+ * @param name 名称的UTF-8数据
+ * @param length 名称的字节数
+ * @param out 输出缓冲区，至少length字节
+ * @return 折叠结果的字节数，不会超过length
+ * 
+ * 全角ASCII字符（U+FF01～U+FF5E）转为半角后再查折叠表，
+ * 全角空格（U+3000）去掉，其他非ASCII字符原样保留。
+ */
+static int foldUtf8(const char *name, int length, char *out)
+{
+    const char *map = nameFoldTable().map;
+    const uchar *bytes = reinterpret_cast<const uchar *>(name);
+    int size = 0;
+    for(int i = 0; i < length; i++)
+    {
+        uchar c = bytes[i];
+        if(c < 0x80)
+        {
+            if(map[c] != 0)
+            {
+                out[size++] = map[c];
+            }
+            continue;
+        }
+
+        // U+FF01～U+FF3F编码为EF BC 81～BF，U+FF40～U+FF5E编码为EF BD 80～9E
+        if(c == 0xEF && i + 2 < length)
+        {
+            int ascii = 0;
+            if(bytes[i + 1] == 0xBC && bytes[i + 2] >= 0x81 && bytes[i + 2] <= 0xBF)
+            {
+                ascii = 0x21 + (bytes[i + 2] - 0x81);
+            }
+            else if(bytes[i + 1] == 0xBD && bytes[i + 2] >= 0x80 && bytes[i + 2] <= 0x9E)
+            {
+                ascii = 0x60 + (bytes[i + 2] - 0x80);
+            }
+            if(ascii != 0)
+            {
+                if(map[ascii] != 0)
+                {
+                    out[size++] = map[ascii];
+                }
+                i += 2;
+                continue;
+            }
+        }
+
+        // U+3000编码为E3 80 80
+        if(c == 0xE3 && i + 2 < length && bytes[i + 1] == 0x80 && bytes[i + 2] == 0x80)
+        {
+            i += 2;
+            continue;
+        }
+        out[size++] = static_cast<char>(c);
+    }
+    return size;
+}
+
+/**
+ * @brief 折叠用户输入的名称
+ * @param name 用户输入
+ * @param out 输出的UTF-8键
+ * 
+ * 在UTF-16转UTF-8的同一遍中查表折叠，结果与foldUtf8(name.toUtf8())相同，
+ * 但不构造中间字符串，常见长度的名称不分配堆内存。
+ */
+static void foldName(const QString &name, QVarLengthArray<char, 256> *out)
+{
+    const char *map = nameFoldTable().map;
+    const ushort *chars = name.utf16();
+    int length = name.size();
+    out->clear();
+    for(int i = 0; i < length; i++)
+    {
+        uint c = chars[i];
+        // 全角ASCII字符转为半角
+        if(c >= 0xFF01 && c <= 0xFF5E)
+        {
+            c -= 0xFEE0;
+        }
+
+        if(c < 0x80)
+        {
+            if(map[c] != 0)
+            {
+                out->append(map[c]);
+            }
+        }
+        else if(c == 0x3000)
+        {
+            // 去掉全角空格
+        }
+        else if(c < 0x800)
+        {
+            out->append(static_cast<char>(0xC0 | (c >> 6)));
+            out->append(static_cast<char>(0x80 | (c & 0x3F)));
+        }
+        else if(QChar::isHighSurrogate(c) && i + 1 < length && QChar::isLowSurrogate(chars[i + 1]))
+        {
+            uint ucs4 = QChar::surrogateToUcs4(static_cast<ushort>(c), chars[++i]);
+            out->append(static_cast<char>(0xF0 | (ucs4 >> 18)));
+            out->append(static_cast<char>(0x80 | ((ucs4 >> 12) & 0x3F)));
+            out->append(static_cast<char>(0x80 | ((ucs4 >> 6) & 0x3F)));
+            out->append(static_cast<char>(0x80 | (ucs4 & 0x3F)));
+        }
+        else
+        {
+            out->append(static_cast<char>(0xE0 | (c >> 12)));
+            out->append(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+            out->append(static_cast<char>(0x80 | (c & 0x3F)));
+        }
+    }
+}
+
+/**
+ * @brief 计算UTF-8片段中的字符数
+ */
+static int utf8CharCount(const char *data, int length)
+{
+    int count = 0;
+    for(int i = 0; i < length; i++)
+    {
+        // 不计算10xxxxxx形式的后续字节
+        if((static_cast<uchar>(data[i]) & 0xC0) != 0x80)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief 计算UTF-8名称去掉行政区划后缀后的词干长度
+ * @return 词干的字节数，没有可去掉的后缀时返回length
+ * 
+ * 与normalizeCityName规则相同，直接在UTF-8字节上比较，用于查询时的词干查找。
+ */
+static int utf8StemLength(const char *name, int length)
+{
+    for(const char *suffix : kAdminSuffixes)
+    {
+        int suffixLength = static_cast<int>(strlen(suffix));
+        if(length > suffixLength
+           && memcmp(name + length - suffixLength, suffix, static_cast<size_t>(suffixLength)) == 0
+           && utf8CharCount(name, length - suffixLength) >= kMinStemLength)
+        {
+            return length - suffixLength;
+        }
+    }
+    return length;
+}
+
+/**
+ * @brief 按UTF-8字节序比较两个片段
+ * @return 小于0、等于0、大于0分别表示a小于、等于、大于b
+ */
+static int compareUtf8(const char *a, int aLength, const char *b, int bLength)
+{
+    int result = memcmp(a, b, static_cast<size_t>(qMin(aLength, bLength)));
+    if(result != 0)
+    {
+        return result;
+    }
+    return aLength - bLength;
+}
+
+// 元素数量少于该值时单线程排序
+static const int kParallelSortThreshold = 64 * 1024;
+
+/**
+ * @brief 并行排序
+ * 
+ * 先把数组均分成若干段在多个线程上分别排序，再逐轮两两归并，
+ * 每一轮的各次归并也并行执行。
+ */
+template <typename T, typename Compare>
+static void parallelSort(QVector<T> &values, Compare lessThan)
+{
+    int count = values.size();
+    int parts = qMin(QThread::idealThreadCount(), count / kParallelSortThreshold);
+    if(parts <= 1)
+    {
+        std::sort(values.begin(), values.end(), lessThan);
+        return;
+    }
+
+    // 在主线程完成分离，工作线程只通过裸指针访问数据
+    T *data = values.data();
+    QVector<int> bounds;
+    for(int i = 0; i <= parts; i++)
+    {
+        bounds.append(static_cast<int>(static_cast<qint64>(count) * i / parts));
+    }
+
+    QVector<QPair<int,int>> ranges;
+    for(int i = 0; i < parts; i++)
+    {
+        ranges.append(qMakePair(bounds[i], bounds[i + 1]));
+    }
+    QtConcurrent::blockingMap(ranges, [data, lessThan](const QPair<int,int> &range) {
+        std::sort(data + range.first, data + range.second, lessThan);
+    });
+
+    // 每轮把相邻的两段归并为一段
+    for(int width = 1; width < parts; width *= 2)
+    {
+        QVector<QPair<int,int>> merges;
+        for(int i = 0; i + width < parts; i += width * 2)
+        {
+            merges.append(qMakePair(i, qMin(i + width * 2, parts)));
+        }
+        QtConcurrent::blockingMap(merges, [data, &bounds, width, lessThan](const QPair<int,int> &merge) {
+            std::inplace_merge(data + bounds[merge.first],
+                               data + bounds[merge.first + width],
+                               data + bounds[merge.second], lessThan);
+        });
+    }
+}
+
+QString CityCodeUtils::formatCityCode(quint32 code)
+{
+    return code == 0 ? QString() : QString("%1").arg(code, 9, 10, QChar('0'));
+}
+
+QString CityCodeUtils::normalizeCityName(const QString &cityName)
+{
+    QString stem = stripSuffix(cityName, kAdminSuffixes,
+                               sizeof(kAdminSuffixes) / sizeof(kAdminSuffixes[0]));
+    return stem.isEmpty() ? cityName : stem;
+}
+
+QStringList CityCodeUtils::cityNameStems(const QString &cityName)
+{
+    QStringList stems;
+    QString stem = normalizeCityName(cityName);
+    stems << stem;
+
+    // 自治地方的词干以民族名称结尾，再去掉民族名称得到地名
+    QString placeName = stripSuffix(stem, kEthnicNames,
+                                    sizeof(kEthnicNames) / sizeof(kEthnicNames[0]));
+    if(!placeName.isEmpty())
+    {
+        stems << placeName;
+    }
+    return stems;
+}
+
+QString CityCandidate::displayName() const
+{
+    return parentName.isEmpty() ? name : QString("%1（%2）").arg(name, parentName);
+}
+
+QString CityCodeUtils::cityName(quint32 index) const
+{
+    const CityRecord &city = mCities.at(index);
+    return QString::fromUtf8(mNamePool.constData() + city.nameOffset, city.nameLength);
+}
+
+CityCandidate CityCodeUtils::makeCandidate(quint32 index) const
+{
+    const CityRecord &city = mCities.at(index);
+    CityCandidate candidate;
+    candidate.code = formatCityCode(city.code);
+    candidate.name = cityName(index);
+    candidate.parentName = city.parent >= 0 ? cityName(city.parent) : QString();
+    candidate.level = city.level;
+    return candidate;
 }
 
 /**
@@ -34,99 +406,540 @@ CityCodeUtils::CityCodeUtils()
  * 
  * 该函数实现智能城市名称匹配，支持多种城市名称格式：
  * 1. 首先尝试精确匹配用户输入的城市名称
- * 2. 如果失败，尝试添加"市"后缀进行匹配
- * 3. 如果仍失败，尝试添加"县"后缀进行匹配
- * 4. 最后尝试添加"区"后缀进行匹配
+ * 2. 如果失败，去掉输入的行政区划后缀得到词干，在预先计算的词干表中查找
  * 
+ * 例如"北京市"、"浦东"、"江华"、"鄂温克族"都可以命中对应的城市。
+ * 候选列表在建立索引时已排序，直接返回第一个候选城市。
  * 如果城市映射表为空，会自动调用InitCityMap()进行初始化。
  * 这种延迟加载策略可以提高应用程序的启动速度。
  */
-QString CityCodeUtils::getCityCodeFromName(QString cityName)
+QString CityCodeUtils::getCityCodeFromName(QString cityName) const
 {
-    // 检查城市映射表是否已初始化，如果为空则进行初始化
-    if(CityMap.isEmpty())
+    const IndexEntry *entry = findCandidates(cityName);
+    if(!entry)
     {
-        InitCityMap();
+        // 所有匹配尝试都失败，返回空字符串表示未找到
+        return "";
     }
-    
-    // 1. 首先尝试精确匹配用户输入的城市名称
-    QMap<QString,QString>::iterator it = CityMap.find(cityName);
-    if( it == CityMap.end())
+    return formatCityCode(mCities.at(mCandidates.at(entry->first)).code);
+}
+
+QVector<CityCandidate> CityCodeUtils::getCityCandidates(const QString &cityName) const
+{
+    QVector<CityCandidate> result;
+    const IndexEntry *entry = findCandidates(cityName);
+    if(entry)
+    {
+        result.reserve(entry->count);
+        for(quint32 i = 0; i < entry->count; i++)
+        {
+            result.append(makeCandidate(mCandidates.at(entry->first + i)));
+        }
+    }
+    return result;
+}
+
+QVector<CityCandidate> CityCodeUtils::completeCityName(const QString &prefix, int count) const
+{
+    QVector<CityCandidate> result;
+    QVarLengthArray<char, 256> key;
+    foldName(prefix, &key);
+    if(key.isEmpty() || count <= 0)
+    {
+        return result;
+    }
+
+    // 二分查找第一个不小于前缀的键
+    const char *pool = mNamePool.constData();
+    const QVector<IndexEntry> &entries = mNameIndex.entries;
+    const IndexEntry *begin = std::lower_bound(entries.constBegin(), entries.constEnd(), key,
+                                               [pool](const IndexEntry &entry, const QVarLengthArray<char, 256> &value) {
+        return compareUtf8(pool + entry.keyOffset, static_cast<int>(entry.keyLength),
+                           value.constData(), value.size()) < 0;
+    });
+
+    // 收集以前缀开头的键对应的城市，同一城市的名称和别名只保留一次
+    QVector<quint32> cities;
+    int scanned = 0;
+    for(const IndexEntry *entry = begin; entry != entries.constEnd() && scanned < kMaxCompletionKeys; ++entry, ++scanned)
     {
-        // 2. 尝试添加"市"后缀进行匹配（适用于地级市）
-        it = CityMap.find(cityName+"市");
-        if( it == CityMap.end())
+        if(entry->keyLength < static_cast<quint32>(key.size())
+           || memcmp(pool + entry->keyOffset, key.constData(), static_cast<size_t>(key.size())) != 0)
         {
-            // 3. 尝试添加"县"后缀进行匹配（适用于县级行政区）
-            it = CityMap.find(cityName+"县");
+            break;
         }
-        if( it == CityMap.end())
+        for(quint32 i = 0; i < entry->count; i++)
         {
-            // 4. 尝试添加"区"后缀进行匹配（适用于市辖区）
-            it = CityMap.find(cityName+"区");
+            quint32 city = mCandidates.at(static_cast<int>(entry->first + i));
+            if(!cities.contains(city))
+            {
+                cities.append(city);
+            }
         }
-        if( it == CityMap.end())
+    }
+
+    // 行政级别高的优先，其次名称短的，即与输入最接近的
+    const CityRecord *records = mCities.constData();
+    std::stable_sort(cities.begin(), cities.end(), [records](quint32 a, quint32 b) {
+        if(records[a].level != records[b].level)
         {
-            // 5. 所有匹配尝试都失败，返回空字符串表示未找到
-            return "";
+            return records[a].level < records[b].level;
         }
+        return records[a].nameLength < records[b].nameLength;
+    });
 
+    result.reserve(qMin(count, cities.size()));
+    for(int i = 0; i < cities.size() && i < count; i++)
+    {
+        result.append(makeCandidate(cities[i]));
     }
-    // 返回找到的城市代码
-    return it.value();
+    return result;
+}
 
+QVector<NearbyCity> CityCodeUtils::makeNearbyCities(const QVector<GeoMatch> &matches) const
+{
+    QVector<NearbyCity> result;
+    result.reserve(matches.size());
+    for(const GeoMatch &match : matches)
+    {
+        NearbyCity nearby;
+        nearby.city = makeCandidate(match.city);
+        nearby.distanceKm = match.distanceKm;
+        result.append(nearby);
+    }
+    return result;
+}
+
+QString CityCodeUtils::nearestCityCode(double latitude, double longitude) const
+{
+    QVector<GeoMatch> matches = mGeoIndex.nearest(latitude, longitude, 1);
+    return matches.isEmpty() ? QString() : formatCityCode(mCities.at(matches.first().city).code);
+}
+
+QVector<NearbyCity> CityCodeUtils::nearestCities(double latitude, double longitude, int count) const
+{
+    return makeNearbyCities(mGeoIndex.nearest(latitude, longitude, count));
+}
+
+QVector<NearbyCity> CityCodeUtils::citiesWithinRadius(double latitude, double longitude, double radiusKm) const
+{
+    return makeNearbyCities(mGeoIndex.withinRadius(latitude, longitude, radiusKm));
+}
+
+const CityCodeUtils::IndexEntry *CityCodeUtils::findEntry(const CityIndex &index,
+                                                          const char *key, int length) const
+{
+    if(index.buckets.isEmpty())
+    {
+        return nullptr;
+    }
+
+    // 线性探测，遇到空位说明键不存在
+    const char *pool = mNamePool.constData();
+    quint32 mask = static_cast<quint32>(index.buckets.size() - 1);
+    quint32 bucket = qHashBits(key, static_cast<size_t>(length)) & mask;
+    while(quint32 slot = index.buckets.at(static_cast<int>(bucket)))
+    {
+        const IndexEntry &entry = index.entries.at(static_cast<int>(slot - 1));
+        if(compareUtf8(pool + entry.keyOffset, static_cast<int>(entry.keyLength),
+                       key, length) == 0)
+        {
+            return &entry;
+        }
+        bucket = (bucket + 1) & mask;
+    }
+    return nullptr;
+}
+
+const CityCodeUtils::IndexEntry *CityCodeUtils::findCandidates(const QString &cityName) const
+{
+    // 按查表折叠输入，结果写入栈上缓冲区
+    QVarLengthArray<char, 256> key;
+    foldName(cityName, &key);
+
+    // 1. 首先按名称查找，正式名称和别名都在名称索引中
+    const IndexEntry *entry = findEntry(mNameIndex, key.constData(), key.size());
+    if(entry)
+    {
+        return entry;
+    }
+
+    // 2. 去掉行政区划后缀，按词干查找一次
+    return findEntry(mStemIndex, key.constData(), utf8StemLength(key.constData(), key.size()));
+}
+
+void CityCodeUtils::buildIndex(QVector<IndexKey> &keys, const QVector<quint32> &rank,
+                               CityIndex *index)
+{
+    // 按键的字节序排序，同一键内按城市排名排序
+    const char *pool = mNamePool.constData();
+    const quint32 *ranks = rank.constData();
+    parallelSort(keys, [pool, ranks](const IndexKey &a, const IndexKey &b) {
+        int result = compareUtf8(pool + a.keyOffset, static_cast<int>(a.keyLength),
+                                 pool + b.keyOffset, static_cast<int>(b.keyLength));
+        if(result != 0)
+        {
+            return result < 0;
+        }
+        return ranks[a.city] < ranks[b.city];
+    });
+
+    // 相同的键合并为一个索引项，候选下标连续追加到mCandidates
+    QVector<IndexEntry> &entries = index->entries;
+    entries.clear();
+    for(int i = 0; i < keys.size(); i++)
+    {
+        const IndexKey &key = keys[i];
+        if(!entries.isEmpty())
+        {
+            IndexEntry &last = entries.last();
+            if(compareUtf8(pool + last.keyOffset, static_cast<int>(last.keyLength),
+                           pool + key.keyOffset, static_cast<int>(key.keyLength)) == 0)
+            {
+                // 同一城市的多个词干可能相同，只保留一次
+                if(mCandidates.last() != key.city)
+                {
+                    mCandidates.append(key.city);
+                    last.count++;
+                }
+                continue;
+            }
+        }
+        IndexEntry entry;
+        entry.keyOffset = key.keyOffset;
+        entry.keyLength = key.keyLength;
+        entry.first = static_cast<quint32>(mCandidates.size());
+        entry.count = 1;
+        mCandidates.append(key.city);
+        entries.append(entry);
+    }
+    entries.squeeze();
+
+    // 哈希表大小取不小于索引项数量两倍的2的幂，负载因子不超过0.5
+    int bucketCount = 16;
+    while(bucketCount < entries.size() * 2)
+    {
+        bucketCount *= 2;
+    }
+    index->buckets.fill(0, bucketCount);
+    quint32 mask = static_cast<quint32>(bucketCount - 1);
+    quint32 *buckets = index->buckets.data();
+    for(int i = 0; i < entries.size(); i++)
+    {
+        const IndexEntry &entry = entries[i];
+        quint32 bucket = qHashBits(pool + entry.keyOffset, entry.keyLength) & mask;
+        while(buckets[bucket] != 0)
+        {
+            bucket = (bucket + 1) & mask;
+        }
+        buckets[bucket] = static_cast<quint32>(i + 1);
+    }
+}
+
+void CityCodeUtils::InitCityMap()
+{
+    build(readCityData(":/citycode.json"), readAliases(":/cityalias.csv"));
 }
 
 /**
- * @brief 初始化城市映射表
- * 
- * 从Qt资源文件":/citycode.json"中读取城市数据，解析JSON格式的城市信息
- * 并填充到CityMap映射表中。该函数通常在首次查询城市代码时自动调用。
+ * @brief 读取城市数据文件
  * 
  * JSON文件格式预期为数组，每个元素包含：
+ * - id: 记录编号
+ * - pid: 上级行政区的记录编号，省级为0
  * - city_name: 城市名称（字符串）
- * - city_code: 城市代码（字符串）
+ * - city_code: 城市代码（字符串或数字）
+ * - population: 人口（可选），用于同级候选城市的排序
+ * - lat/lon: 纬度和经度（可选），带坐标的城市加入空间索引
  * 
- * 如果JSON文件格式不正确或读取失败，映射表将保持为空。
+ * 数据不构建QJsonDocument，由CityDataReader在原始字节上并行流式扫描。
+ * 如果文件读取失败，返回空的数据块列表。
  */
-void CityCodeUtils::InitCityMap()
+QVector<CityDataChunk> CityCodeUtils::readCityData(const QString &filePath)
 {
-    // 打开Qt资源文件中的城市代码JSON数据
-    QFile file(":/citycode.json");
+    // 打开城市代码JSON数据
+    QFile file(filePath);
     
     // 以只读模式打开文件
-    file.open(QIODevice::ReadOnly);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "无法读取城市数据:" << filePath << file.errorString();
+        return QVector<CityDataChunk>();
+    }
     
-    // 读取文件的全部内容到字节数组
-    QByteArray rawData = file.readAll();
+    // 未压缩的资源和外部文件直接映射，压缩的资源需要解压读取
+    QByteArray rawData;
+    const char *data = reinterpret_cast<const char *>(file.map(0, file.size()));
+    qint64 size = file.size();
+    if(!data)
+    {
+        rawData = file.readAll();
+        data = rawData.constData();
+        size = rawData.size();
+    }
+
+    // 并行读取全部城市记录
+    QVector<CityDataChunk> chunks = CityDataReader::read(data, size);
     
     // 关闭文件释放资源
     file.close();
+    return chunks;
+}
 
-    // 将字节数组解析为JSON文档
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(rawData);
-    
-    // 检查JSON文档是否为数组格式
-    if(jsonDoc.isArray())
+/**
+ * @brief 读取城市别名文件
+ * 
+ * 别名文件很小，按行切分即可。格式错误的行被跳过并汇总输出一条警告。
+ */
+QVector<CityAlias> CityCodeUtils::readAliases(const QString &filePath)
+{
+    QVector<CityAlias> aliases;
+    QFile file(filePath);
+    if(!file.open(QIODevice::ReadOnly))
     {
-        // 获取城市数据数组
-        QJsonArray citys = jsonDoc.array();
-        
-        // 遍历数组中的每个城市数据项
-        for(QJsonValue val : citys)
+        qWarning() << "无法读取城市别名:" << filePath << file.errorString();
+        return aliases;
+    }
+
+    int invalid = 0;
+    const QList<QByteArray> lines = file.readAll().split('\n');
+    for(const QByteArray &rawLine : lines)
+    {
+        QByteArray line = rawLine.trimmed();
+        if(line.isEmpty() || line.startsWith('#'))
+        {
+            continue;
+        }
+
+        // 别名中可能含有逗号以外的任意字符，以最后一个逗号分隔城市代码
+        int comma = line.lastIndexOf(',');
+        bool ok = false;
+        CityAlias alias;
+        alias.name = line.left(comma).trimmed();
+        alias.code = comma > 0 ? line.mid(comma + 1).trimmed().toUInt(&ok) : 0;
+        if(!ok || alias.name.isEmpty() || alias.code == 0)
         {
-            // 检查当前项是否为有效的JSON对象
-            if(val.isObject())
+            invalid++;
+            continue;
+        }
+        aliases.append(alias);
+    }
+
+    if(invalid > 0)
+    {
+        qWarning() << "城市别名文件中有" << invalid << "行格式错误，已跳过:" << filePath;
+    }
+    return aliases;
+}
+
+/**
+ * @brief 根据城市记录建立索引
+ * 
+ * 词干计算和索引排序分配到多个线程，建立完成后索引只读。
+ */
+void CityCodeUtils::build(const QVector<CityDataChunk> &chunks, const QVector<CityAlias> &aliases)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // 第一遍：合并各数据块的名称池和记录，记录编号与上级编号
+    int total = 0;
+    int poolSize = 0;
+    for(const CityDataChunk &chunk : chunks)
+    {
+        total += chunk.records.size();
+        poolSize += chunk.namePool.size();
+    }
+    mNamePool.clear();
+    mNamePool.reserve(poolSize);
+    mCities.clear();
+    mCities.reserve(total);
+
+    QVector<qint64> parentIds;
+    QVector<double> populations;
+    QHash<qint64,int> indexById;
+    QVector<GeoPoint> geoPoints;
+    parentIds.reserve(total);
+    populations.reserve(total);
+    indexById.reserve(total);
+    for(const CityDataChunk &chunk : chunks)
+    {
+        quint32 base = static_cast<quint32>(mNamePool.size());
+        mNamePool.append(chunk.namePool);
+        for(const CityDataRecord &record : chunk.records)
+        {
+            CityRecord city;
+            city.code = record.code;
+            city.nameOffset = base + record.nameOffset;
+            city.nameLength = record.nameLength;
+            city.level = 0;
+            city.parent = -1;
+
+            // 带坐标的城市加入空间索引，缺失的坐标为NaN
+            if(!qIsNaN(record.latitude) && !qIsNaN(record.longitude))
             {
-                // 从JSON对象中提取城市名称
-                QString cityName = val["city_name"].toString();
-                
-                // 从JSON对象中提取城市代码
-                QString cityCode = val["city_code"].toString();
-                
-                // 将城市名称和代码的映射关系插入到映射表中
-                CityMap.insert(cityName,cityCode);
+                GeoPoint point;
+                point.latitude = record.latitude;
+                point.longitude = record.longitude;
+                point.city = static_cast<quint32>(mCities.size());
+                geoPoints.append(point);
             }
+
+            indexById.insert(record.id, mCities.size());
+            parentIds.append(record.pid);
+            populations.append(record.population);
+            mCities.append(city);
         }
     }
+    mGeoIndex.build(geoPoints);
+
+    // 第二遍：沿pid向上计算行政级别，并记录上级行政区
+    for(int i = 0; i < mCities.size(); i++)
+    {
+        int level = 0;
+        int parentIndex = indexById.value(parentIds[i], -1);
+        mCities[i].parent = parentIndex;
+        // 层级上限用于防止数据中出现环
+        while(parentIndex >= 0 && level < 8)
+        {
+            level++;
+            parentIndex = indexById.value(parentIds[parentIndex], -1);
+        }
+        mCities[i].level = static_cast<quint8>(level);
+    }
+
+    // 候选排名只在建立索引时计算一次：级别高的优先，其次人口多的，最后按文件顺序
+    QVector<quint32> order(mCities.size());
+    for(int i = 0; i < order.size(); i++)
+    {
+        order[i] = static_cast<quint32>(i);
+    }
+    const CityRecord *cities = mCities.constData();
+    const double *population = populations.constData();
+    parallelSort(order, [cities, population](quint32 a, quint32 b) {
+        if(cities[a].level != cities[b].level)
+        {
+            return cities[a].level < cities[b].level;
+        }
+        if(population[a] != population[b])
+        {
+            return population[a] > population[b];
+        }
+        return a < b;
+    });
+    QVector<quint32> rank(mCities.size());
+    for(int i = 0; i < order.size(); i++)
+    {
+        rank[order[i]] = static_cast<quint32>(i);
+    }
+
+    // 名称键：折叠后与原名称相同时直接引用原名称，否则把折叠结果追加到名称池，
+    // nameKeys的前mCities.size()项与城市一一对应
+    QVector<IndexKey> nameKeys;
+    nameKeys.reserve(mCities.size() + aliases.size());
+    QByteArray folded;
+    for(int i = 0; i < mCities.size(); i++)
+    {
+        const CityRecord &city = mCities[i];
+        folded.resize(city.nameLength);
+        int length = foldUtf8(mNamePool.constData() + city.nameOffset, city.nameLength, folded.data());
+
+        IndexKey key;
+        key.keyOffset = city.nameOffset;
+        key.keyLength = city.nameLength;
+        key.city = static_cast<quint32>(i);
+        if(length > 0 && compareUtf8(folded.constData(), length,
+                                     mNamePool.constData() + city.nameOffset, city.nameLength) != 0)
+        {
+            key.keyOffset = static_cast<quint32>(mNamePool.size());
+            key.keyLength = static_cast<quint32>(length);
+            mNamePool.append(folded.constData(), length);
+        }
+        nameKeys.append(key);
+    }
+
+    // 别名键同样折叠后追加到名称池，通过城市代码找到对应的城市，
+    // 同一代码出现多次时以第一条为准
+    int aliasCount = 0;
+    if(!aliases.isEmpty())
+    {
+        QHash<quint32,int> indexByCode;
+        indexByCode.reserve(mCities.size());
+        for(int i = mCities.size() - 1; i >= 0; i--)
+        {
+            indexByCode.insert(mCities[i].code, i);
+        }
+
+        for(const CityAlias &alias : aliases)
+        {
+            int city = indexByCode.value(alias.code, -1);
+            folded.resize(alias.name.size());
+            int length = foldUtf8(alias.name.constData(), alias.name.size(), folded.data());
+            if(city < 0 || length == 0)
+            {
+                continue;
+            }
+            IndexKey key;
+            key.keyOffset = static_cast<quint32>(mNamePool.size());
+            key.keyLength = static_cast<quint32>(length);
+            key.city = static_cast<quint32>(city);
+            mNamePool.append(folded.constData(), length);
+            nameKeys.append(key);
+            aliasCount++;
+        }
+        if(aliasCount != aliases.size())
+        {
+            qWarning() << "城市别名中有" << aliases.size() - aliasCount << "项引用了不存在的城市代码，已跳过";
+        }
+    }
+    mNamePool.squeeze();
+
+    // 第三遍：并行计算每个城市的词干长度，每个城市最多两个词干，0表示没有。
+    // 行政区划后缀和民族名称都是中文，不受折叠影响，在折叠后的名称上计算即可
+    QVector<quint16> stemLengths(mCities.size() * 2, 0);
+    quint16 *stems = stemLengths.data();
+    const char *pool = mNamePool.constData();
+    const IndexKey *cityKeys = nameKeys.constData();
+    QVector<QPair<int,int>> ranges;
+    int step = qMax(1024, mCities.size() / (QThread::idealThreadCount() * 4) + 1);
+    for(int begin = 0; begin < mCities.size(); begin += step)
+    {
+        ranges.append(qMakePair(begin, qMin(begin + step, mCities.size())));
+    }
+    QtConcurrent::blockingMap(ranges, [pool, cityKeys, stems](const QPair<int,int> &range) {
+        for(int i = range.first; i < range.second; i++)
+        {
+            const QStringList cityStems = cityNameStems(
+                        QString::fromUtf8(pool + cityKeys[i].keyOffset, static_cast<int>(cityKeys[i].keyLength)));
+            for(int j = 0; j < cityStems.size() && j < 2; j++)
+            {
+                stems[i * 2 + j] = static_cast<quint16>(cityStems[j].toUtf8().size());
+            }
+        }
+    });
+
+    // 收集词干键，词干是折叠后名称的前缀，键直接引用名称池中的片段
+    QVector<IndexKey> stemKeys;
+    stemKeys.reserve(mCities.size() * 2);
+    for(int i = 0; i < mCities.size(); i++)
+    {
+        IndexKey key = nameKeys[i];
+        for(int j = 0; j < 2 && stems[i * 2 + j] != 0; j++)
+        {
+            key.keyLength = stems[i * 2 + j];
+            stemKeys.append(key);
+        }
+    }
+
+    mCandidates.clear();
+    mCandidates.reserve(nameKeys.size() + stemKeys.size());
+    buildIndex(nameKeys, rank, &mNameIndex);
+    buildIndex(stemKeys, rank, &mStemIndex);
+    mCandidates.squeeze();
+
+    qDebug() << "城市索引建立完成:" << mCities.size() << "条记录，"
+             << aliasCount << "个别名，"
+             << mNameIndex.entries.size() << "个名称，"
+             << mStemIndex.entries.size() << "个词干，"
+             << geoPoints.size() << "个坐标，耗时" << timer.elapsed() << "ms";
 }
@@ -12,8 +12,56 @@
 #ifndef CITYCODEUTILS_H
 #define CITYCODEUTILS_H
 
-#include <QMap>         // Qt映射容器，用于存储城市名称到代码的映射
+#include "citydatareader.h" // 城市数据记录
+#include "geoindex.h"       // 城市坐标空间索引
+
+#include <QByteArray>   // UTF-8名称池
+#include <QSharedPointer> // 共享索引快照
 #include <QString>      // Qt字符串类
+#include <QStringList>  // Qt字符串列表
+#include <QVector>      // Qt向量容器，用于存储城市记录和候选列表
+
+/**
+ * @struct CityCandidate
+ * @brief 城市查询的候选结果
+ * 
+ * 同名或词干相同的城市可能有多个（如北京和南通都有"通州区"），
+ * 候选结果携带上级行政区名称，便于界面区分展示。
+ */
+struct CityCandidate
+{
+    QString code;           // 城市代码
+    QString name;           // 城市名称
+    QString parentName;     // 上级行政区名称，省级城市为空
+    int level;              // 行政级别：0为省级，1为地级，2为县级，以此类推
+
+    /**
+     * @brief 获取用于界面展示的名称，如"通州区（北京）"
+     */
+    QString displayName() const;
+};
+
+/**
+ * @struct CityAlias
+ * @brief 城市别名
+ * 
+ * 英文名、历史名称或常用简称，如"Peking"、"北平"、"京"都指向北京。
+ */
+struct CityAlias
+{
+    QByteArray name;        // 别名（UTF-8）
+    quint32 code;           // 城市代码
+};
+
+/**
+ * @struct NearbyCity
+ * @brief 按坐标查询得到的城市
+ */
+struct NearbyCity
+{
+    CityCandidate city;     // 城市
+    double distanceKm;      // 与查询坐标的球面距离（千米）
+};
 
 /**
  * @class CityCodeUtils
@@ -25,50 +73,281 @@
  * 主要功能：
  * - 从JSON资源文件加载全国城市代码数据
  * - 根据城市名称查找对应的城市代码
- * - 支持多种城市名称格式（市、县、区等后缀）
+ * - 支持多种城市名称格式（市、县、区、自治州、盟、旗、新区等行政区划后缀）
+ * - 支持英文名、历史名称和常用简称（见cityalias.csv），与正式名称同一次查找命中
  * - 提供高效的城市代码查询服务
+ * 
+ * 内存布局：
+ * - 全部城市名称以UTF-8连续存放在一个名称池中，记录中只保存32位偏移和长度
+ * - 城市代码以quint32保存，只在返回给界面时格式化为字符串
+ * - 名称和词干索引是按UTF-8字节序排序的数组，键为名称池中的片段，
+ *   词干总是名称的前缀，因此不需要额外存储
+ * - 每个索引附带一个开放寻址哈希表，查询时间与数据规模无关
+ * - 名称索引的键经过折叠：英文字母转为小写，全角字符转为半角，去掉空格、
+ *   连字符、撇号和点；折叠后与原名称不同的键和别名键追加到名称池末尾
+ * - 数据中带有经纬度的城市另外建立k-d树（见GeoIndex），支持按坐标查询最近城市
+ * 
+ * 城市数据以流式方式并行读取（见CityDataReader），词干计算和索引排序
+ * 也分配到多个线程，可以加载数十万条记录的全球城市列表。
+ * 
+ * 索引建立完成后只读，查询函数均为const，可以被多个线程同时使用；
+ * 运行时更新由CityIndexManager在后台建立新索引并整体替换。
  */
 class CityCodeUtils
 {
 public:
+    /**
+     * @brief 自动补全时最多检查的索引键数量，避免单个字母的前缀遍历整个索引
+     */
+    static const int kMaxCompletionKeys = 512;
+
     /**
      * @brief 默认构造函数
      * 
-     * 创建CityCodeUtils实例，城市映射表将在首次使用时延迟初始化。
+     * 创建空的CityCodeUtils实例，需要调用InitCityMap或build建立索引后才能查询。
      */
     CityCodeUtils();
 
     /**
-     * @brief 城市名称到城市代码的映射表
+     * @brief 根据城市名称获取城市代码
+     * @param cityName 城市名称（支持带或不带行政区划后缀）
+     * @return 对应的城市代码，如果未找到则返回空字符串
+     * 
+     * 查找过程：
+     * 1. 按折叠后的城市名称在名称索引中查找，正式名称和别名都在其中
+     * 2. 去掉输入的行政区划后缀得到词干，在词干映射表中查找一次
+     * 
+     * 折叠按查表逐字符进行，直接写入栈上缓冲区，查询过程不分配堆内存。
+     * 
+     * 有多个候选城市时返回排名最高的一个。
+     */
+    QString getCityCodeFromName(QString cityName) const;
+    
+    /**
+     * @brief 获取城市名称对应的全部候选城市
+     * @param cityName 城市名称（支持带或不带行政区划后缀）
+     * @return 候选城市列表，第一项即getCityCodeFromName返回的城市，未找到时为空
      * 
-     * 存储从JSON文件加载的城市数据，键为城市名称，值为对应的城市代码。
-     * 该映射表在首次调用getCityCodeFromName时自动初始化。
+     * 排名在建立索引时已计算完成：行政级别高的优先，
+     * 其次是人口多的（数据中提供population字段时），最后按数据文件中的顺序。
      */
-    QMap<QString,QString> CityMap ={};
+    QVector<CityCandidate> getCityCandidates(const QString &cityName) const;
     
     /**
-     * @brief 根据城市名称获取城市代码
-     * @param cityName 城市名称（支持带或不带"市"、"县"、"区"后缀）
-     * @return 对应的城市代码，如果未找到则返回空字符串
+     * @brief 获取名称以给定前缀开头的城市，用于搜索框自动补全
+     * @param prefix 用户已输入的前缀，与查询使用相同的折叠规则
+     * @param count 最多返回的城市数量
+     * @return 补全候选，行政级别高的和名称短的优先，每个城市只出现一次
      * 
-     * 该函数会自动尝试多种城市名称格式：
-     * 1. 原始输入的城市名称
-     * 2. 城市名称 + "市"
-     * 3. 城市名称 + "县"
-     * 4. 城市名称 + "区"
+     * 名称索引按UTF-8字节序排序，前缀相同的键连续存放，
+     * 二分查找到起点后顺序遍历，最多检查kMaxCompletionKeys个键。
+     */
+    QVector<CityCandidate> completeCityName(const QString &prefix, int count) const;
+    
+    /**
+     * @brief 获取离给定坐标最近的城市代码
+     * @param latitude 纬度（度）
+     * @param longitude 经度（度）
+     * @return 城市代码，数据中没有坐标时返回空字符串
+     * 
+     * 用于把传感器或GPS坐标高频映射到预报城市，只格式化一个城市代码，不构造候选结果。
+     */
+    QString nearestCityCode(double latitude, double longitude) const;
+    
+    /**
+     * @brief 获取离给定坐标最近的若干个城市
+     * @param latitude 纬度（度）
+     * @param longitude 经度（度）
+     * @param count 最多返回的城市数量
+     * @return 按距离从近到远排列的城市，数据中没有坐标时为空
+     */
+    QVector<NearbyCity> nearestCities(double latitude, double longitude, int count) const;
+    
+    /**
+     * @brief 获取给定半径内的全部城市
+     * @param latitude 纬度（度）
+     * @param longitude 经度（度）
+     * @param radiusKm 半径（千米）
+     * @return 按距离从近到远排列的城市，数据中没有坐标时为空
+     */
+    QVector<NearbyCity> citiesWithinRadius(double latitude, double longitude, double radiusKm) const;
+    
+    /**
+     * @brief 将城市代码格式化为天气API使用的9位字符串
+     * @param code 城市代码，0表示没有代码
+     * @return 城市代码字符串，code为0时返回空字符串
+     */
+    static QString formatCityCode(quint32 code);
+    
+    /**
+     * @brief 去掉城市名称的行政区划后缀
+     * @param cityName 城市名称
+     * @return 词干，没有可去掉的后缀时返回原名称
      * 
-     * 如果映射表为空，会自动调用InitCityMap()进行初始化。
+     * 按从长到短的顺序尝试"特别行政区"、"自治州"、"新区"、"市"、"盟"、"旗"等后缀，
+     * 去掉后缀后至少保留两个字，避免"清新区"被截成"清"。
      */
-    QString getCityCodeFromName(QString cityName);
+    static QString normalizeCityName(const QString &cityName);
+    
+    /**
+     * @brief 计算城市名称的所有词干
+     * @param cityName 数据文件中的城市名称
+     * @return 词干列表，第一项为去掉行政区划后缀的词干
+     * 
+     * 自治地方的词干再去掉结尾的民族名称，例如"江华瑶族自治县"的词干为
+     * "江华瑶族"和"江华"，使用户输入任一形式都能命中。
+     */
+    static QStringList cityNameStems(const QString &cityName);
     
     /**
      * @brief 初始化城市映射表
      * 
-     * 从资源文件":/citycode.json"中读取城市数据，
-     * 解析JSON格式的城市信息并填充到CityMap中。
-     * 该函数通常在首次查询城市代码时自动调用。
+     * 从资源文件":/citycode.json"和":/cityalias.csv"中读取城市数据和别名并建立索引，
+     * 相当于build(readCityData(":/citycode.json"), readAliases(":/cityalias.csv"))。
      */
     void InitCityMap();
+    
+    /**
+     * @brief 读取城市数据文件
+     * @param filePath 文件路径，可以是资源路径
+     * @return 按文件顺序排列的数据块，文件无法读取时为空
+     * 
+     * 只使用可重入的函数，可以在后台线程中调用。
+     */
+    static QVector<CityDataChunk> readCityData(const QString &filePath);
+    
+    /**
+     * @brief 读取城市别名文件
+     * @param filePath 文件路径，可以是资源路径
+     * @return 别名列表，文件无法读取时为空
+     * 
+     * 每行为"别名,城市代码"，空行和以#开头的行被忽略。
+     * 只使用可重入的函数，可以在后台线程中调用。
+     */
+    static QVector<CityAlias> readAliases(const QString &filePath);
+    
+    /**
+     * @brief 根据城市记录建立索引，替换原有内容
+     * @param chunks 城市数据块
+     * @param aliases 城市别名，城市代码不存在的别名被跳过
+     * 
+     * 将名称写入名称池，根据pid计算每个城市的行政级别，
+     * 建立名称索引、词干索引和空间索引，并对同名候选城市排序。
+     * 别名与正式名称编入同一个名称索引，同一别名对应多个城市时按城市排名排序。
+     */
+    void build(const QVector<CityDataChunk> &chunks,
+               const QVector<CityAlias> &aliases = QVector<CityAlias>());
+    
+    /**
+     * @brief 索引中的城市数量
+     */
+    int cityCount() const;
+
+private:
+    /**
+     * @brief 城市记录
+     * 
+     * 名称保存在mNamePool中，记录本身不持有任何堆内存。
+     */
+    struct CityRecord
+    {
+        quint32 code;           // 城市代码，0表示没有代码
+        quint32 nameOffset;     // 名称在名称池中的偏移
+        quint16 nameLength;     // 名称的UTF-8字节数
+        quint8 level;           // 行政级别：0为省级，1为地级，2为县级，以此类推
+        qint32 parent;          // 上级行政区在mCities中的下标，没有上级时为-1
+    };
+    
+    /**
+     * @brief 索引项
+     * 
+     * 键为名称池中的一个片段，值为mCandidates中一段连续的城市下标，
+     * 已按排名从高到低排序。
+     */
+    struct IndexEntry
+    {
+        quint32 keyOffset;      // 键在名称池中的偏移
+        quint32 keyLength;      // 键的UTF-8字节数
+        quint32 first;          // 候选列表在mCandidates中的起始位置
+        quint32 count;          // 候选城市数量
+    };
+    
+    /**
+     * @brief 名称或词干索引
+     * 
+     * entries按键的UTF-8字节序排序，便于前缀遍历；
+     * buckets是以键的哈希值寻址的开放寻址表，保存entries下标加1，0表示空位，
+     * 大小为2的幂且至少是entries数量的两倍，平均探测次数接近1。
+     */
+    struct CityIndex
+    {
+        QVector<IndexEntry> entries;    // 按键排序的索引项
+        QVector<quint32> buckets;       // 哈希表
+    };
+    
+    /**
+     * @brief 建立索引时使用的（键，城市）对
+     */
+    struct IndexKey
+    {
+        quint32 keyOffset;      // 键在名称池中的偏移
+        quint32 keyLength;      // 键的UTF-8字节数
+        quint32 city;           // 城市在mCities中的下标
+    };
+    
+    /**
+     * @brief 将（键，城市）对按键分组，生成排序后的索引和哈希表
+     * @param keys （键，城市）对，函数内会被并行排序
+     * @param rank 城市排名，值越小排名越高
+     * @param index 输出的索引
+     */
+    void buildIndex(QVector<IndexKey> &keys, const QVector<quint32> &rank, CityIndex *index);
+    
+    /**
+     * @brief 在索引中查找UTF-8键
+     * @param index 名称或词干索引
+     * @param key 键的UTF-8数据
+     * @param length 键的字节数
+     * @return 索引项，未找到时返回nullptr
+     */
+    const IndexEntry *findEntry(const CityIndex &index, const char *key, int length) const;
+
+    
+    /**
+     * @brief 查找城市名称对应的索引项
+     * @param cityName 城市名称
+     * @return 索引项，未找到时返回nullptr
+     */
+    const IndexEntry *findCandidates(const QString &cityName) const;
+    
+    /**
+     * @brief 在界面边界将城市记录转换为候选结果
+     */
+    CityCandidate makeCandidate(quint32 index) const;
+    
+    /**
+     * @brief 将空间查询结果转换为城市列表
+     */
+    QVector<NearbyCity> makeNearbyCities(const QVector<GeoMatch> &matches) const;
+    
+    /**
+     * @brief 获取城市名称
+     */
+    QString cityName(quint32 index) const;
+    
+    QByteArray mNamePool;               // 全部城市名称的UTF-8数据
+    QVector<CityRecord> mCities;        // 城市记录
+    CityIndex mNameIndex;               // 名称索引
+    CityIndex mStemIndex;               // 词干索引
+    QVector<quint32> mCandidates;       // 两个索引共用的候选城市下标
+    GeoIndex mGeoIndex;                 // 有坐标的城市的空间索引
 };
 
+/**
+ * @brief 城市索引快照类型
+ * 
+ * 指向只读城市索引的共享指针，持有者在索引被替换后仍可安全使用旧快照。
+ */
+typedef QSharedPointer<const CityCodeUtils> CityIndexSnapshot;
+
 #endif // CITYCODEUTILS_H
@@ -0,0 +1,389 @@
+/**
+ * @file citydatareader.cpp
+ * @brief 城市数据流式读取类的实现文件
+ * @author Weather Forecast Team
+ * @date 2025
+ */
+
+#include "citydatareader.h"   // 城市数据流式读取类头文件
+#include "jsonscan.h"         // JSON字节扫描
+
+#include <QDebug>             // 调试输出
+#include <QThread>            // CPU核心数
+#include <QtNumeric>          // qQNaN，缺失坐标
+#include <QtConcurrent>       // 多线程并行读取
+
+#include <cstdlib>            // strtod
+#include <cstring>            // memcmp
+
+// 每个数据块的最小字节数，小于该值时不值得拆分到多个线程
+static const qint64 kMinChunkSize = 256 * 1024;
+
+/**
+ * @brief 将Unicode码位按UTF-8编码追加到out
+ */
+static void appendUtf8(QByteArray *out, uint codePoint)
+{
+    if(codePoint < 0x80)
+    {
+        out->append(static_cast<char>(codePoint));
+    }
+    else if(codePoint < 0x800)
+    {
+        out->append(static_cast<char>(0xC0 | (codePoint >> 6)));
+        out->append(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+    else if(codePoint < 0x10000)
+    {
+        out->append(static_cast<char>(0xE0 | (codePoint >> 12)));
+        out->append(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out->append(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+    else
+    {
+        out->append(static_cast<char>(0xF0 | (codePoint >> 18)));
+        out->append(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        out->append(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out->append(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+/**
+ * @brief 读取一个JSON字符串
+ * @param p 指向开头的引号
+ * @param out 解码后的UTF-8数据追加到out，为nullptr时只跳过
+ * @return 结尾引号之后的位置，格式错误时返回nullptr
+ *
+ * 没有转义字符时直接整段追加，只有含转义的字符串才逐字节解码。
+ */
+static const char *parseString(const char *p, const char *end, QByteArray *out)
+{
+    p++;
+    const char *runStart = p;
+    while(p < end)
+    {
+        char c = *p;
+        if(c == '"')
+        {
+            if(out)
+            {
+                out->append(runStart, static_cast<int>(p - runStart));
+            }
+            return p + 1;
+        }
+        if(c != '\\')
+        {
+            p++;
+            continue;
+        }
+
+        // 处理转义字符
+        if(out)
+        {
+            out->append(runStart, static_cast<int>(p - runStart));
+        }
+        if(end - p < 2)
+        {
+            return nullptr;
+        }
+        char escape = p[1];
+        p += 2;
+        switch(escape)
+        {
+        case '"':  if(out) out->append('"');  break;
+        case '\\': if(out) out->append('\\'); break;
+        case '/':  if(out) out->append('/');  break;
+        case 'b':  if(out) out->append('\b'); break;
+        case 'f':  if(out) out->append('\f'); break;
+        case 'n':  if(out) out->append('\n'); break;
+        case 'r':  if(out) out->append('\r'); break;
+        case 't':  if(out) out->append('\t'); break;
+        case 'u':
+        {
+            uint codePoint = 0;
+            if(!JsonScan::parseHex4(p, end, &codePoint))
+            {
+                return nullptr;
+            }
+            p += 4;
+            // 代理对组合为一个码位
+            uint low = 0;
+            if(codePoint >= 0xD800 && codePoint < 0xDC00 && end - p >= 6
+                    && p[0] == '\\' && p[1] == 'u' && JsonScan::parseHex4(p + 2, end, &low)
+                    && low >= 0xDC00 && low < 0xE000)
+            {
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                p += 6;
+            }
+            if(out)
+            {
+                appendUtf8(out, codePoint);
+            }
+            break;
+        }
+        default:
+            return nullptr;
+        }
+        runStart = p;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief 读取一个数字或数字字符串（如"101010100"）
+ * @return 数值之后的位置，格式错误时返回nullptr
+ */
+static const char *parseNumber(const char *p, const char *end, double *value)
+{
+    if(p < end && *p == '"')
+    {
+        QByteArray text;
+        const char *next = parseString(p, end, &text);
+        if(next)
+        {
+            *value = text.toDouble();
+        }
+        return next;
+    }
+
+    // 数字长度有限，复制到栈上的缓冲区再转换，避免strtod越过数据块结尾
+    char buffer[64];
+    int length = 0;
+    while(p < end && length < static_cast<int>(sizeof(buffer)) - 1
+          && ((*p >= '0' && *p <= '9') || *p == '-' || *p == '+'
+              || *p == '.' || *p == 'e' || *p == 'E'))
+    {
+        buffer[length++] = *p++;
+    }
+    if(length == 0)
+    {
+        return nullptr;
+    }
+    buffer[length] = '\0';
+    *value = strtod(buffer, nullptr);
+    return p;
+}
+
+/**
+ * @brief 判断键是否等于给定的ASCII字符串
+ */
+static bool keyEquals(const QByteArray &key, const char *name, int length)
+{
+    return key.size() == length && memcmp(key.constData(), name, static_cast<size_t>(length)) == 0;
+}
+
+CityDataChunk CityDataReader::readChunk(const char *begin, const char *end)
+{
+    return readChunk(begin, end, nullptr);
+}
+
+CityDataChunk CityDataReader::readChunk(const char *begin, const char *end, bool *flat)
+{
+    // 只有读到块的结尾（或数组结尾）且没有遇到嵌套的对象或数组时，块边界才一定是记录边界
+    bool nested = false;
+    bool finished = false;
+    CityDataChunk chunk;
+    // 名称平均不超过10个字节，对象平均不少于50个字节，按此预留空间
+    chunk.records.reserve(static_cast<int>((end - begin) / 50 + 1));
+    chunk.namePool.reserve(static_cast<int>((end - begin) / 5 + 1));
+
+    QByteArray key;
+    const char *p = begin;
+    while(true)
+    {
+        // 找到下一个对象的开头，跳过数组括号和对象之间的逗号
+        p = JsonScan::skipSpace(p, end);
+        while(p < end && (*p == '[' || *p == ','))
+        {
+            p = JsonScan::skipSpace(p + 1, end);
+        }
+        if(p >= end || *p != '{')
+        {
+            finished = p >= end || *p == ']';
+            break;
+        }
+        p = JsonScan::skipSpace(p + 1, end);
+
+        CityDataRecord record;
+        record.id = 0;
+        record.pid = 0;
+        record.code = 0;
+        record.population = 0;
+        record.latitude = qQNaN();
+        record.longitude = qQNaN();
+        record.nameOffset = static_cast<quint32>(chunk.namePool.size());
+        record.nameLength = 0;
+        bool hasName = false;
+
+        // 逐个读取"键":值
+        while(p && p < end && *p != '}')
+        {
+            if(*p != '"')
+            {
+                p = nullptr;
+                break;
+            }
+            key.clear();
+            p = parseString(p, end, &key);
+            if(!p)
+            {
+                break;
+            }
+            p = JsonScan::skipSpace(p, end);
+            if(p >= end || *p != ':')
+            {
+                p = nullptr;
+                break;
+            }
+            p = JsonScan::skipSpace(p + 1, end);
+
+            double number = 0;
+            if(keyEquals(key, "city_name", 9) && p < end && *p == '"')
+            {
+                p = parseString(p, end, &chunk.namePool);
+                hasName = true;
+            }
+            else if(keyEquals(key, "city_code", 9))
+            {
+                p = parseNumber(p, end, &number);
+                record.code = static_cast<quint32>(number);
+            }
+            else if(keyEquals(key, "id", 2))
+            {
+                p = parseNumber(p, end, &number);
+                record.id = static_cast<qint64>(number);
+            }
+            else if(keyEquals(key, "pid", 3))
+            {
+                p = parseNumber(p, end, &number);
+                record.pid = static_cast<qint64>(number);
+            }
+            else if(keyEquals(key, "population", 10))
+            {
+                p = parseNumber(p, end, &number);
+                record.population = number;
+            }
+            else if(keyEquals(key, "lat", 3) || keyEquals(key, "latitude", 8))
+            {
+                p = parseNumber(p, end, &number);
+                record.latitude = number;
+            }
+            else if(keyEquals(key, "lon", 3) || keyEquals(key, "lng", 3)
+                    || keyEquals(key, "longitude", 9))
+            {
+                p = parseNumber(p, end, &number);
+                record.longitude = number;
+            }
+            else
+            {
+                if(p < end && (*p == '{' || *p == '['))
+                {
+                    nested = true;
+                }
+                p = JsonScan::skipValue(p, end);
+            }
+            if(!p)
+            {
+                break;
+            }
+            p = JsonScan::skipSpace(p, end);
+            if(p < end && *p == ',')
+            {
+                p = JsonScan::skipSpace(p + 1, end);
+            }
+        }
+
+        // 格式错误时停止读取，丢弃读了一半的记录
+        if(!p || p >= end)
+        {
+            chunk.namePool.truncate(static_cast<int>(record.nameOffset));
+            break;
+        }
+        p++;
+
+        if(hasName)
+        {
+            record.nameLength = static_cast<quint16>(chunk.namePool.size() - static_cast<int>(record.nameOffset));
+            chunk.records.append(record);
+        }
+    }
+
+    if(flat)
+    {
+        *flat = finished && !nested;
+    }
+    chunk.records.squeeze();
+    chunk.namePool.squeeze();
+    return chunk;
+}
+
+QVector<qint64> CityDataReader::splitChunks(const char *data, qint64 size, int count)
+{
+    QVector<qint64> bounds;
+    bounds.append(0);
+    for(int i = 1; i < count; i++)
+    {
+        // 从均分点向后找到"},{"形式的对象边界，块从下一个对象的开头开始
+        const char *p = data + qMax(bounds.last(), size * i / count);
+        const char *end = data + size;
+        while(p < end)
+        {
+            if(*p == '}')
+            {
+                const char *next = JsonScan::skipSpace(p + 1, end);
+                if(next < end && *next == ',')
+                {
+                    next = JsonScan::skipSpace(next + 1, end);
+                    if(next < end && *next == '{')
+                    {
+                        p = next;
+                        break;
+                    }
+                }
+            }
+            p++;
+        }
+        if(p >= end)
+        {
+            break;
+        }
+        bounds.append(p - data);
+    }
+    bounds.append(size);
+    return bounds;
+}
+
+QVector<CityDataChunk> CityDataReader::read(const char *data, qint64 size)
+{
+    int count = static_cast<int>(qBound<qint64>(1, size / kMinChunkSize, QThread::idealThreadCount()));
+    if(count == 1)
+    {
+        return QVector<CityDataChunk>() << readChunk(data, data + size);
+    }
+
+    QVector<qint64> bounds = splitChunks(data, size, count);
+    int chunkCount = bounds.size() - 1;
+    QVector<int> indices;
+    for(int i = 0; i < chunkCount; i++)
+    {
+        indices.append(i);
+    }
+
+    // 每个块写入自己的下标，合并后的记录顺序与文件一致
+    QVector<CityDataChunk> chunks(chunkCount);
+    QVector<char> flat(chunkCount, 0);
+    QtConcurrent::blockingMap(indices, [&](int i) {
+        bool chunkFlat = false;
+        chunks[i] = readChunk(data + bounds[i], data + bounds[i + 1], &chunkFlat);
+        flat[i] = chunkFlat;
+    });
+
+    // 切分点只在扁平记录的数据中可靠。记录含有嵌套的对象或数组时，"},{"可能位于
+    // 记录内部，切分出的块会在中途出错；此时丢弃并行结果，整体按顺序重新读取
+    if(flat.contains(0))
+    {
+        qWarning() << "城市数据不是扁平记录或切分点不在记录边界，改为顺序读取";
+        return QVector<CityDataChunk>() << readChunk(data, data + size);
+    }
+    return chunks;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file citydatareader.h
+ * @brief 城市数据流式读取类的头文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 该文件定义了CityDataReader类，直接在城市数据JSON的原始字节上流式扫描，
+ * 不构建QJsonDocument，只提取城市索引需要的字段。
+ * 数据按对象边界切分成若干块，由QtConcurrent在多个线程上并行扫描，
+ * 可以在一秒内读取数十万条记录的全球城市列表。
+ */
+
+#ifndef CITYDATAREADER_H
+#define CITYDATAREADER_H
+
+#include <QByteArray>   // UTF-8名称池
+#include <QVector>      // 记录列表
+
+/**
+ * @struct CityDataRecord
+ * @brief 从数据文件中读取的一条城市记录
+ */
+struct CityDataRecord
+{
+    qint64 id;              // 记录编号
+    qint64 pid;             // 上级行政区的记录编号，省级为0
+    quint32 code;           // 城市代码，0表示没有代码
+    double population;      // 人口，数据中没有该字段时为0
+    double latitude;        // 纬度（度），数据中没有坐标时为NaN
+    double longitude;       // 经度（度），数据中没有坐标时为NaN
+    quint32 nameOffset;     // 名称在所属块名称池中的偏移
+    quint16 nameLength;     // 名称的UTF-8字节数
+};
+
+/**
+ * @struct CityDataChunk
+ * @brief 一个数据块的读取结果
+ */
+struct CityDataChunk
+{
+    QByteArray namePool;                // 本块全部城市名称的UTF-8数据
+    QVector<CityDataRecord> records;    // 本块的城市记录，保持文件中的顺序
+};
+
+/**
+ * @class CityDataReader
+ * @brief 城市数据JSON的流式并行读取器
+ *
+ * 数据格式为扁平对象组成的数组：
+ *     [{"id":1,"pid":0,"city_code":"101010100","city_name":"北京"}, ...]
+ *
+ * 识别的字段为id、pid、city_code（字符串或数字）、city_name，
+ * 以及可选的population和坐标（lat/latitude、lon/lng/longitude），其他字段直接跳过，支持带缩进的原始数据和去掉空白的精简数据。
+ */
+class CityDataReader
+{
+public:
+    /**
+     * @brief 并行读取全部城市记录
+     * @param data JSON数据
+     * @param size 字节数
+     * @return 按文件顺序排列的数据块
+     *
+     * 块数取决于数据大小和CPU核心数，小数据只使用一个块。
+     */
+    static QVector<CityDataChunk> read(const char *data, qint64 size);
+
+    /**
+     * @brief 读取一段数据中的全部城市记录
+     * @param begin 数据块起始位置，位于对象开头或数组开头
+     * @param end 数据块结束位置
+     *
+     * 遇到格式错误时停止读取，返回已读取的记录。
+     */
+    static CityDataChunk readChunk(const char *begin, const char *end);
+
+private:
+    /**
+     * @brief 将数据按对象边界切分成若干块
+     * @param data JSON数据
+     * @param size 字节数
+     * @param count 期望的块数
+     * @return 各块的起始偏移，最后一项为size
+     *
+     * 只在均分点之后寻找"},{"，不跟踪嵌套层次，因此只对扁平记录可靠；
+     * read()用readChunk的flat结果检查每个块，发现嵌套时改为顺序读取。
+     */
+    static QVector<qint64> splitChunks(const char *data, qint64 size, int count);
+
+    /**
+     * @brief 读取一段数据中的全部城市记录，并报告块边界是否可靠
+     * @param flat 不为nullptr时写入是否读到了块的结尾，且所有记录都是扁平的
+     *             （没有对象或数组类型的值）
+     */
+    static CityDataChunk readChunk(const char *begin, const char *end, bool *flat);
+};
+
+#endif // CITYDATAREADER_H
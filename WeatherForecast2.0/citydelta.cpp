@@ -0,0 +1,317 @@
+/**
+ * @file citydelta.cpp
+ * @brief 城市数据增量更新类的实现文件
+ * @author Weather Forecast Team
+ * @date 2025
+ */
+
+#include "citydelta.h"        // 城市数据增量更新类头文件
+
+#include <QDebug>             // 调试输出
+#include <QFile>              // 读取增量文件
+#include <QHash>              // 城市代码到记录位置的映射
+#include <QJsonArray>         // JSON数组
+#include <QJsonDocument>      // 增量文件很小，直接用QJsonDocument解析
+#include <QJsonObject>        // JSON对象
+#include <QPair>              // （数据块，记录）位置
+#include <QSet>               // 已删除的记录
+#include <QtNumeric>          // qQNaN，缺失坐标
+
+/**
+ * @brief 读取城市代码字段，支持字符串和数字
+ * @return 城市代码，缺失或无效时返回0
+ */
+static quint32 codeValue(const QJsonValue &value)
+{
+    if(value.isString())
+    {
+        return value.toString().toUInt();
+    }
+    return value.isDouble() ? static_cast<quint32>(value.toDouble()) : 0;
+}
+
+/**
+ * @brief 读取可选的坐标字段
+ * @return 坐标，缺失时返回NaN
+ */
+static double coordinateValue(const QJsonObject &object, const char *shortKey, const char *longKey)
+{
+    QJsonValue value = object.value(QLatin1String(shortKey));
+    if(value.isUndefined())
+    {
+        value = object.value(QLatin1String(longKey));
+    }
+    return value.isDouble() ? value.toDouble() : qQNaN();
+}
+
+bool CityDelta::fromFile(const QString &filePath, CityDelta *delta, QString *errorMessage)
+{
+    // 增量文件不存在表示没有增量修改
+    if(!QFile::exists(filePath))
+    {
+        *delta = CityDelta();
+        return true;
+    }
+
+    QFile file(filePath);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        if(errorMessage)
+        {
+            *errorMessage = QString("无法读取增量文件 %1: %2").arg(filePath, file.errorString());
+        }
+        return false;
+    }
+    return fromJson(file.readAll(), delta, errorMessage);
+}
+
+bool CityDelta::fromJson(const QByteArray &json, CityDelta *delta, QString *errorMessage)
+{
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(json, &parseError);
+    if(!document.isObject())
+    {
+        if(errorMessage)
+        {
+            *errorMessage = QString("增量文件格式错误: %1").arg(parseError.errorString());
+        }
+        return false;
+    }
+
+    QJsonObject root = document.object();
+    int version = root.value("version").toInt();
+    if(version != kVersion)
+    {
+        if(errorMessage)
+        {
+            *errorMessage = QString("不支持的增量文件版本: %1").arg(version);
+        }
+        return false;
+    }
+
+    // 先完整校验全部操作，任何一项无效时整个文件都不生效
+    CityDelta result;
+    const QJsonArray operations = root.value("operations").toArray();
+    for(int i = 0; i < operations.size(); i++)
+    {
+        QJsonObject object = operations.at(i).toObject();
+        QString op = object.value("op").toString();
+
+        Operation operation;
+        operation.code = codeValue(object.value("city_code"));
+        operation.newCode = codeValue(object.value("new_code"));
+        operation.name = object.value("city_name").toString().toUtf8();
+        if(operation.code == 0)
+        {
+            if(errorMessage)
+            {
+                *errorMessage = QString("第%1项操作缺少有效的city_code").arg(i + 1);
+            }
+            return false;
+        }
+
+        if(op == "add")
+        {
+            if(operation.name.isEmpty())
+            {
+                if(errorMessage)
+                {
+                    *errorMessage = QString("第%1项add操作缺少city_name").arg(i + 1);
+                }
+                return false;
+            }
+            operation.type = Add;
+            // 没有id的新城市使用负数编号，不会与数据文件中的编号冲突
+            operation.record.id = object.contains("id")
+                    ? static_cast<qint64>(object.value("id").toDouble()) : -1 - i;
+            operation.record.pid = static_cast<qint64>(object.value("pid").toDouble());
+            operation.record.code = operation.code;
+            operation.record.population = object.value("population").toDouble();
+            operation.record.latitude = coordinateValue(object, "lat", "latitude");
+            operation.record.longitude = coordinateValue(object, "lon", "longitude");
+            operation.record.nameOffset = 0;
+            operation.record.nameLength = 0;
+        }
+        else if(op == "remove")
+        {
+            operation.type = Remove;
+        }
+        else if(op == "rename")
+        {
+            if(operation.name.isEmpty() && operation.newCode == 0)
+            {
+                if(errorMessage)
+                {
+                    *errorMessage = QString("第%1项rename操作缺少city_name或new_code").arg(i + 1);
+                }
+                return false;
+            }
+            operation.type = Rename;
+        }
+        else
+        {
+            if(errorMessage)
+            {
+                *errorMessage = QString("第%1项操作类型未知: %2").arg(i + 1).arg(op);
+            }
+            return false;
+        }
+        result.mOperations.append(operation);
+    }
+
+    *delta = result;
+    return true;
+}
+
+bool CityDelta::applyTo(QVector<CityDataChunk> *target, int *appliedCount, QString *errorMessage) const
+{
+    if(appliedCount)
+    {
+        *appliedCount = 0;
+    }
+    if(mOperations.isEmpty())
+    {
+        return true;
+    }
+
+    // 在副本上应用，出现冲突时目标数据保持不变；数据块隐式共享，只有被修改的块才会复制
+    QVector<CityDataChunk> copy = *target;
+    QVector<CityDataChunk> *chunks = &copy;
+
+    // 新增的城市放在单独的数据块中，排在原有数据之后
+    chunks->append(CityDataChunk());
+    int addedChunk = chunks->size() - 1;
+
+    // 城市代码到（数据块，记录）位置的映射，同一代码出现多次时以第一条为准
+    QHash<quint32, QPair<int,int>> positions;
+    for(int c = 0; c < chunks->size(); c++)
+    {
+        const QVector<CityDataRecord> &records = chunks->at(c).records;
+        for(int r = 0; r < records.size(); r++)
+        {
+            if(!positions.contains(records[r].code))
+            {
+                positions.insert(records[r].code, qMakePair(c, r));
+            }
+        }
+    }
+
+    QSet<QPair<int,int>> removed;
+    QSet<int> removedChunks;
+    int applied = 0;
+    for(int i = 0; i < mOperations.size(); i++)
+    {
+        const Operation &operation = mOperations.at(i);
+        QHash<quint32, QPair<int,int>>::iterator it = positions.find(operation.code);
+        bool exists = it != positions.end();
+
+        switch(operation.type)
+        {
+        case Add:
+        {
+            // 代码已存在时原位替换，保持在候选排名中的文件顺序
+            QPair<int,int> position = exists ? it.value()
+                                             : qMakePair(addedChunk, (*chunks)[addedChunk].records.size());
+            CityDataChunk &chunk = (*chunks)[position.first];
+            CityDataRecord record = operation.record;
+            record.nameOffset = static_cast<quint32>(chunk.namePool.size());
+            record.nameLength = static_cast<quint16>(operation.name.size());
+            chunk.namePool.append(operation.name);
+            if(exists)
+            {
+                chunk.records[position.second] = record;
+            }
+            else
+            {
+                chunk.records.append(record);
+                positions.insert(operation.code, position);
+            }
+            applied++;
+            break;
+        }
+        case Remove:
+            if(exists)
+            {
+                removed.insert(it.value());
+                removedChunks.insert(it.value().first);
+                positions.erase(it);
+                applied++;
+            }
+            break;
+        case Rename:
+            if(exists)
+            {
+                QPair<int,int> position = it.value();
+                CityDataChunk &chunk = (*chunks)[position.first];
+                CityDataRecord &record = chunk.records[position.second];
+                // 新名称追加到所在数据块的名称池，旧名称的字节不再被引用
+                if(!operation.name.isEmpty())
+                {
+                    record.nameOffset = static_cast<quint32>(chunk.namePool.size());
+                    record.nameLength = static_cast<quint16>(operation.name.size());
+                    chunk.namePool.append(operation.name);
+                }
+                if(operation.newCode != 0 && operation.newCode != operation.code)
+                {
+                    // 新代码已被另一个城市使用时两条记录会共用一个代码，之后的remove只能删除其中一条
+                    if(positions.contains(operation.newCode))
+                    {
+                        if(errorMessage)
+                        {
+                            *errorMessage = QString("第%1项rename操作的new_code已被其他城市使用: %2")
+                                    .arg(i + 1).arg(operation.newCode, 9, 10, QChar('0'));
+                        }
+                        return false;
+                    }
+                    record.code = operation.newCode;
+                    positions.erase(it);
+                    positions.insert(operation.newCode, position);
+                }
+                applied++;
+            }
+            break;
+        }
+    }
+
+    // 删除被移除的记录，只重建包含被删除记录的数据块
+    for(int c : removedChunks)
+    {
+        CityDataChunk &chunk = (*chunks)[c];
+        QVector<CityDataRecord> kept;
+        kept.reserve(chunk.records.size());
+        for(int r = 0; r < chunk.records.size(); r++)
+        {
+            if(!removed.contains(qMakePair(c, r)))
+            {
+                kept.append(chunk.records[r]);
+            }
+        }
+        chunk.records = kept;
+    }
+
+    if((*chunks)[addedChunk].records.isEmpty())
+    {
+        chunks->removeLast();
+    }
+
+    if(applied != mOperations.size())
+    {
+        qWarning() << "城市增量文件中有" << mOperations.size() - applied << "项操作引用了不存在的城市代码，已跳过";
+    }
+    *target = copy;
+    if(appliedCount)
+    {
+        *appliedCount = applied;
+    }
+    return true;
+}
+
+int CityDelta::size() const
+{
+    return mOperations.size();
+}
+
+bool CityDelta::isEmpty() const
+{
+    return mOperations.isEmpty();
+}
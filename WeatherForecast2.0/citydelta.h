@@ -0,0 +1,119 @@
+/**
+ * @file citydelta.h
+ * @brief 城市数据增量更新类的头文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 该文件定义了CityDelta类，表示叠加在内置城市数据之上的一组增量修改。
+ * 上游新增、删除城市或修改城市名称、代码时，只需发布一个小的增量文件，
+ * 无需重新编译和部署程序。
+ *
+ * 增量文件格式（JSON）：
+ *     {
+ *         "version": 1,
+ *         "operations": [
+ *             {"op": "add", "id": 5001, "pid": 12, "city_code": "101999999", "city_name": "新城区"},
+ *             {"op": "remove", "city_code": "101010100"},
+ *             {"op": "rename", "city_code": "101010200", "city_name": "海淀区", "new_code": "101010201"}
+ *         ]
+ *     }
+ *
+ * - add：新增城市；city_code已存在时替换该城市的全部字段。
+ *   id、pid、population、lat、lon为可选字段
+ * - remove：删除城市代码对应的城市
+ * - rename：修改城市名称（city_name）和/或城市代码（new_code）；
+ *   new_code已被另一个城市使用时整个增量无效
+ *
+ * 操作按文件中的顺序依次执行，引用不存在的城市代码的操作会被跳过。
+ */
+
+#ifndef CITYDELTA_H
+#define CITYDELTA_H
+
+#include "citydatareader.h" // 城市数据记录
+
+#include <QByteArray>       // UTF-8名称
+#include <QString>          // Qt字符串类
+#include <QVector>          // 操作列表
+
+/**
+ * @class CityDelta
+ * @brief 城市数据的增量修改
+ */
+class CityDelta
+{
+public:
+    /**
+     * @brief 支持的增量文件版本号
+     */
+    static const int kVersion = 1;
+
+    /**
+     * @brief 从增量文件读取
+     * @param filePath 文件路径
+     * @param delta 读取成功时写入结果
+     * @param errorMessage 读取失败时写入失败原因，可为nullptr
+     * @return 是否读取成功，文件不存在时返回true并得到空的增量
+     *
+     * 只使用可重入的函数，可以在后台线程中调用。
+     */
+    static bool fromFile(const QString &filePath, CityDelta *delta, QString *errorMessage = nullptr);
+
+    /**
+     * @brief 从JSON数据读取
+     * @param json 增量文件内容
+     * @param delta 读取成功时写入结果
+     * @param errorMessage 读取失败时写入失败原因，可为nullptr
+     * @return 是否读取成功
+     */
+    static bool fromJson(const QByteArray &json, CityDelta *delta, QString *errorMessage = nullptr);
+
+    /**
+     * @brief 将增量修改应用到城市数据上
+     * @param target 城市数据块，新增的城市追加到最后一个新数据块中
+     * @param appliedCount 不为nullptr时写入成功执行的操作数量
+     * @param errorMessage 应用失败时写入失败原因，可为nullptr
+     * @return 是否应用成功
+     *
+     * 有些错误只有对照城市数据才能发现，如rename的new_code已被另一个城市使用。
+     * 出现这类冲突时整个增量无效，target保持不变，与文件格式错误的处理一致。
+     */
+    bool applyTo(QVector<CityDataChunk> *target, int *appliedCount = nullptr, QString *errorMessage = nullptr) const;
+
+    /**
+     * @brief 操作数量
+     */
+    int size() const;
+
+    /**
+     * @brief 是否没有任何操作
+     */
+    bool isEmpty() const;
+
+private:
+    /**
+     * @brief 操作类型
+     */
+    enum OperationType
+    {
+        Add,        // 新增或替换城市
+        Remove,     // 删除城市
+        Rename      // 修改名称和/或城市代码
+    };
+
+    /**
+     * @brief 一个增量操作
+     */
+    struct Operation
+    {
+        OperationType type;     // 操作类型
+        quint32 code;           // 操作的城市代码
+        quint32 newCode;        // rename的新城市代码，0表示不修改
+        QByteArray name;        // add/rename的城市名称（UTF-8），rename为空表示不修改
+        CityDataRecord record;  // add的城市记录，nameOffset和nameLength在应用时填写
+    };
+
+    QVector<Operation> mOperations;     // 按文件顺序排列的操作
+};
+
+#endif // CITYDELTA_H
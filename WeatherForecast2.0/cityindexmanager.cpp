@@ -0,0 +1,187 @@
+/**
+ * @file cityindexmanager.cpp
+ * @brief 城市索引管理类的实现文件
+ * @author Weather Forecast Team
+ * @date 2025
+ */
+
+#include "cityindexmanager.h" // 城市索引管理类头文件
+#include "citydelta.h"        // 城市数据增量更新
+
+#include <QDebug>             // 调试输出
+#include <QElapsedTimer>      // 更新耗时统计
+#include <QFileInfo>          // 文件路径信息
+#include <QFileSystemWatcher> // 文件变化监视
+#include <QTimer>             // 防抖定时器
+#include <QtConcurrent>       // 后台线程建立索引
+
+// 收到修改通知后等待的时间（毫秒），合并编辑器保存时产生的多次通知
+static const int kRebuildDebounceMs = 300;
+
+CityIndexManager::CityIndexManager(const QString &basePath, const QString &aliasPath, const QString &deltaPath,
+                                   QObject *parent)
+    : QObject(parent)
+    , mBasePath(basePath)
+    , mAliasPath(aliasPath)
+    , mDeltaPath(deltaPath)
+    , mWatcher(new QFileSystemWatcher(this))
+    , mDebounceTimer(new QTimer(this))
+    , mBuildPending(false)
+{
+    mDebounceTimer->setSingleShot(true);
+    mDebounceTimer->setInterval(kRebuildDebounceMs);
+    connect(mDebounceTimer, &QTimer::timeout, this, &CityIndexManager::startRebuild);
+
+    // 同时监视文件本身和所在目录，目录通知用于捕获文件的创建和替换
+    connect(mWatcher, &QFileSystemWatcher::fileChanged, this, &CityIndexManager::onFileChanged);
+    connect(mWatcher, &QFileSystemWatcher::directoryChanged, this, &CityIndexManager::onFileChanged);
+    connect(&mBuildWatcher, &QFutureWatcher<BuildResult>::finished, this, &CityIndexManager::onBuildFinished);
+    rewatch();
+
+    // 启动时在后台建立索引，不阻塞窗口显示
+    mInitialBuild = QtConcurrent::run(&CityIndexManager::build,
+                                      mBasePath, QSharedPointer<const QVector<CityDataChunk>>(),
+                                      mAliasPath, QSharedPointer<const QVector<CityAlias>>(), mDeltaPath);
+    mBuildWatcher.setFuture(mInitialBuild);
+}
+
+CityIndexManager::~CityIndexManager()
+{
+    mBuildWatcher.waitForFinished();
+}
+
+CityIndexSnapshot CityIndexManager::snapshot()
+{
+    QMutexLocker locker(&mMutex);
+    if(!mSnapshot)
+    {
+        // 首次建立索引尚未完成，等待其完成后直接使用结果，
+        // onBuildFinished稍后会看到快照已经就绪
+        locker.unlock();
+        mInitialBuild.waitForFinished();
+        locker.relock();
+        if(!mSnapshot)
+        {
+            mSnapshot = mInitialBuild.result().index;
+        }
+    }
+    return mSnapshot;
+}
+
+QString CityIndexManager::deltaPath() const
+{
+    return mDeltaPath;
+}
+
+void CityIndexManager::onFileChanged()
+{
+    rewatch();
+    mDebounceTimer->start();
+}
+
+void CityIndexManager::startRebuild()
+{
+    // 上一次建立索引尚未完成时只做标记，完成后再建立一次
+    if(mBuildWatcher.isRunning())
+    {
+        mBuildPending = true;
+        return;
+    }
+    mBuildWatcher.setFuture(QtConcurrent::run(&CityIndexManager::build, mBasePath, mBaseData,
+                                              mAliasPath, mAliases, mDeltaPath));
+}
+
+void CityIndexManager::onBuildFinished()
+{
+    BuildResult result = mBuildWatcher.result();
+    mBaseData = result.baseData;
+    mAliases = result.aliases;
+
+    CityIndexSnapshot oldSnapshot;
+    {
+        QMutexLocker locker(&mMutex);
+        oldSnapshot = mSnapshot;
+    }
+
+    if(!result.errorMessage.isEmpty() && oldSnapshot)
+    {
+        // 增量文件无效时保留当前索引，避免一次错误的编辑使城市查询失效
+        qWarning() << "城市增量文件无效，保留当前索引:" << result.errorMessage;
+    }
+    else
+    {
+        if(!result.errorMessage.isEmpty())
+        {
+            qWarning() << "城市增量文件无效，只使用内置城市数据:" << result.errorMessage;
+        }
+        // 首次建立的索引可能已经被snapshot()提前取用，此时不重复通知
+        if(result.index != oldSnapshot)
+        {
+            {
+                QMutexLocker locker(&mMutex);
+                mSnapshot = result.index;
+            }
+            emit indexChanged(result.index);
+        }
+    }
+
+    if(mBuildPending)
+    {
+        mBuildPending = false;
+        startRebuild();
+    }
+}
+
+CityIndexManager::BuildResult CityIndexManager::build(const QString &basePath,
+                                                      QSharedPointer<const QVector<CityDataChunk>> baseData,
+                                                      const QString &aliasPath,
+                                                      QSharedPointer<const QVector<CityAlias>> aliases,
+                                                      const QString &deltaPath)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    BuildResult result;
+    result.baseData = baseData;
+    if(!result.baseData)
+    {
+        result.baseData = QSharedPointer<const QVector<CityDataChunk>>(
+                    new QVector<CityDataChunk>(CityCodeUtils::readCityData(basePath)));
+    }
+    result.aliases = aliases;
+    if(!result.aliases)
+    {
+        result.aliases = QSharedPointer<const QVector<CityAlias>>(
+                    new QVector<CityAlias>(CityCodeUtils::readAliases(aliasPath)));
+    }
+
+    // 增量应用在内置数据的副本上，内置数据本身保持不变，供下次更新使用
+    QVector<CityDataChunk> chunks = *result.baseData;
+    CityDelta delta;
+    int applied = 0;
+    if(CityDelta::fromFile(deltaPath, &delta, &result.errorMessage))
+    {
+        delta.applyTo(&chunks, &applied, &result.errorMessage);
+    }
+
+    QSharedPointer<CityCodeUtils> index(new CityCodeUtils());
+    index->build(chunks, *result.aliases);
+    result.index = index;
+
+    qDebug() << "城市索引更新完成: 应用" << applied << "项增量修改，"
+             << index->cityCount() << "条记录，耗时" << timer.elapsed() << "ms";
+    return result;
+}
+
+void CityIndexManager::rewatch()
+{
+    QString dirPath = QFileInfo(mDeltaPath).absolutePath();
+    if(!mWatcher->directories().contains(dirPath))
+    {
+        mWatcher->addPath(dirPath);
+    }
+    if(QFileInfo::exists(mDeltaPath) && !mWatcher->files().contains(mDeltaPath))
+    {
+        mWatcher->addPath(mDeltaPath);
+    }
+}
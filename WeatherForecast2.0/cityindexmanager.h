@@ -0,0 +1,139 @@
+/**
+ * @file cityindexmanager.h
+ * @brief 城市索引管理类的头文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 该文件定义了CityIndexManager类，负责在后台线程中加载内置城市数据和别名、
+ * 叠加增量文件（见CityDelta）并建立城市索引，以原子方式替换当前的索引快照。
+ * 增量文件被修改时自动重新建立索引，查询不会被阻塞，也无需重启程序。
+ */
+
+#ifndef CITYINDEXMANAGER_H
+#define CITYINDEXMANAGER_H
+
+#include "citycodeutils.h"      // 城市索引
+
+#include <QObject>              // Qt对象基类
+#include <QString>              // Qt字符串类
+#include <QSharedPointer>       // 共享的基础城市数据
+#include <QMutex>               // 互斥锁，保护快照指针的替换
+#include <QFuture>              // 首次建立索引的任务
+#include <QFutureWatcher>       // 监视后台建立索引任务的完成
+
+class QFileSystemWatcher;
+class QTimer;
+
+/**
+ * @class CityIndexManager
+ * @brief 支持增量更新的城市索引管理类
+ *
+ * 主要功能：
+ * - 启动时在后台线程建立索引，首次查询时如果尚未完成则等待其完成
+ * - 内置城市数据和别名只读取一次，之后每次更新只重新应用增量并建立索引
+ * - 监视增量文件的修改、替换和创建，合并短时间内的多次修改通知
+ * - 增量文件无效时保留当前索引
+ * - 以原子方式替换索引快照并发出indexChanged信号
+ */
+class CityIndexManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造函数
+     * @param basePath 内置城市数据路径，如":/citycode.json"
+     * @param aliasPath 城市别名文件路径，如":/cityalias.csv"
+     * @param deltaPath 增量文件路径，文件可以暂不存在
+     * @param parent 父对象指针
+     */
+    CityIndexManager(const QString &basePath, const QString &aliasPath, const QString &deltaPath,
+                     QObject *parent = nullptr);
+
+    /**
+     * @brief 析构函数，等待后台任务结束
+     */
+    ~CityIndexManager();
+
+    /**
+     * @brief 获取当前索引快照
+     * @return 当前生效的索引快照，不会为空指针，可在任意线程调用
+     *
+     * 首次建立索引尚未完成时阻塞等待，与原先首次查询时同步加载的行为一致。
+     */
+    CityIndexSnapshot snapshot();
+
+    /**
+     * @brief 获取增量文件路径
+     */
+    QString deltaPath() const;
+
+signals:
+    /**
+     * @brief 索引快照被替换后发出
+     * @param index 新的索引快照
+     */
+    void indexChanged(CityIndexSnapshot index);
+
+private slots:
+    /**
+     * @brief 增量文件或其所在目录发生变化
+     */
+    void onFileChanged();
+
+    /**
+     * @brief 防抖定时器到期，启动后台建立索引任务
+     */
+    void startRebuild();
+
+    /**
+     * @brief 后台任务完成，替换快照
+     */
+    void onBuildFinished();
+
+private:
+    /**
+     * @brief 后台任务的结果
+     */
+    struct BuildResult
+    {
+        QSharedPointer<const QVector<CityDataChunk>> baseData;  // 内置城市数据
+        QSharedPointer<const QVector<CityAlias>> aliases;       // 城市别名
+        CityIndexSnapshot index;                                // 新的索引
+        QString errorMessage;                                   // 增量文件无效时的原因
+    };
+
+    /**
+     * @brief 在后台线程读取数据、应用增量并建立索引
+     * @param basePath 内置城市数据路径
+     * @param baseData 已读取的内置城市数据，为空时从basePath读取
+     * @param aliasPath 城市别名文件路径
+     * @param aliases 已读取的城市别名，为空时从aliasPath读取
+     * @param deltaPath 增量文件路径
+     */
+    static BuildResult build(const QString &basePath,
+                             QSharedPointer<const QVector<CityDataChunk>> baseData,
+                             const QString &aliasPath,
+                             QSharedPointer<const QVector<CityAlias>> aliases,
+                             const QString &deltaPath);
+
+    /**
+     * @brief 将增量文件重新加入监视列表
+     */
+    void rewatch();
+
+    QString mBasePath;                                      // 内置城市数据路径
+    QString mAliasPath;                                     // 城市别名文件路径
+    QString mDeltaPath;                                     // 增量文件路径
+    QMutex mMutex;                                          // 保护mSnapshot的读写
+    CityIndexSnapshot mSnapshot;                            // 当前生效的索引快照
+    QSharedPointer<const QVector<CityDataChunk>> mBaseData; // 已读取的内置城市数据
+    QSharedPointer<const QVector<CityAlias>> mAliases;      // 已读取的城市别名
+    QFuture<BuildResult> mInitialBuild;                     // 首次建立索引的任务
+    QFileSystemWatcher *mWatcher;                           // 文件监视器
+    QTimer *mDebounceTimer;                                 // 修改通知防抖定时器
+    QFutureWatcher<BuildResult> mBuildWatcher;              // 后台任务监视器
+    bool mBuildPending;                                     // 建立索引期间是否又收到了修改通知
+};
+
+#endif // CITYINDEXMANAGER_H
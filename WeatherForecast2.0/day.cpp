@@ -13,7 +13,7 @@
 /**
  * @brief Day类的默认构造函数
  * 
- * 创建一个Day实例，所有成员变量将被自动初始化为空字符串。
+ * 创建一个Day实例，所有文字字段将被自动初始化为空视图。
  * 这种设计允许在创建对象后根据需要逐步填充天气数据，
  * 或者通过网络请求获取数据后再进行赋值。
  * 
@@ -23,7 +23,12 @@
  * - 作为天气数据传递的载体
  */
 Day::Day()
+    : mDayNumber(ForecastDate::kInvalidDay)
+    , mTempLowValue(0)
+    , mTempHighValue(0)
+    , mWeatherTypeId(WeatherTables::kUnknownWeatherType)
+    , mAirqId(WeatherTables::kUnknownAirQuality)
 {
-    // 构造函数体为空，QString成员变量会自动初始化为空字符串
+    // 构造函数体为空，QStringView成员变量会自动初始化为空视图
     // 这种设计模式允许延迟数据填充，提高了类的灵活性
 }
@@ -7,12 +7,19 @@
  * 该文件定义了Day类，用于存储单日的完整天气信息。
  * 包含日期、温度、天气类型、空气质量等多维度的天气数据。
  * 该类作为天气数据的基本存储单元，在整个天气预报应用中广泛使用。
+ * 
+ * 文字字段是指向解析内存池（ParseArena）的视图，由LazyForecast::day填写，
+ * 不持有内存；持有Day的一方必须同时持有对应的ForecastRecord快照
+ * （或LazyForecast），在界面边界才转换为QString。
  */
 
 #ifndef DAY_H
 #define DAY_H
 
-#include <QString>      // Qt字符串类，用于存储文本数据
+#include <QStringView>  // 指向解析内存池中文字的只读视图
+
+#include "forecastdate.h"   // 日序号
+#include "weathertables.h"  // 天气类型与空气质量ID
 
 /**
  * @class Day
@@ -33,31 +40,27 @@ public:
     /**
      * @brief 默认构造函数
      * 
-     * 创建Day实例，所有字符串成员变量将被初始化为空字符串。
+     * 创建Day实例，所有文字字段初始化为空视图，日序号初始化为无效，
+     * 温度数值初始化为0，天气类型和空气质量ID初始化为未知。
      */
     Day();
     
     // ========== 日期时间信息 ==========
     /**
-     * @brief 日期信息
+     * @brief 日序号
      * 
-     * 存储天气数据对应的日期，通常格式为"YYYY-MM-DD"或"MM月DD日"。
+     * 天气数据对应的日期，自1970-01-01起的天数，由响应中"YYYY-MM-DD"格式的日期
+     * 直接转换得到；星期和显示用的文字由ForecastDate推算。
+     * 没有日期或格式错误时为ForecastDate::kInvalidDay。
      */
-    QString mDate;
-    
-    /**
-     * @brief 星期信息
-     * 
-     * 存储对应日期的星期几，如"星期一"、"周二"等。
-     */
-    QString mWeek;
+    qint32 mDayNumber;
     
     /**
      * @brief 城市名称
      * 
      * 存储天气数据对应的城市名称，如"北京"、"上海"等。
      */
-    QString mCity;
+    QStringView mCity;
     
     // ========== 温度信息 ==========
     /**
@@ -65,21 +68,30 @@ public:
      * 
      * 存储当前时刻的气温，通常包含温度数值和单位，如"22°C"。
      */
-    QString mTemp;
+    QStringView mTemp;
     
     /**
      * @brief 最低温度
      * 
      * 存储当日的最低气温，通常包含温度数值和单位，如"15°C"。
      */
-    QString mTempLow;
+    QStringView mTempLow;
     
     /**
      * @brief 最高温度
      * 
      * 存储当日的最高气温，通常包含温度数值和单位，如"25°C"。
      */
-    QString mTempHigh;
+    QStringView mTempHigh;
+    
+    /**
+     * @brief 最低温度和最高温度的数值
+     * 
+     * 解析时由mTempLow和mTempHigh转换得到，绘制温度曲线时直接使用，
+     * 文字不是整数时为0。
+     */
+    int mTempLowValue;
+    int mTempHighValue;
     
     // ========== 天气状况 ==========
     /**
@@ -88,14 +100,21 @@ public:
      * 存储天气状况描述，如"晴"、"多云"、"小雨"、"雪"等。
      * 该字段用于确定显示的天气图标和背景样式。
      */
-    QString mWeathType;
+    QStringView mWeathType;
+    
+    /**
+     * @brief 天气类型ID
+     * 
+     * 解析时由mWeathType查表得到，界面更新时用于直接索引天气图标。
+     */
+    WeatherTypeId mWeatherTypeId;
     
     /**
      * @brief 生活提示
      * 
      * 存储基于当日天气状况的生活建议，如穿衣指数、出行提醒等。
      */
-    QString mTips;
+    QStringView mTips;
     
     // ========== 风力信息 ==========
     /**
@@ -103,14 +122,14 @@ public:
      * 
      * 存储风向信息，如"东北风"、"西南风"、"无持续风向"等。
      */
-    QString mFx;
+    QStringView mFx;
     
     /**
      * @brief 风力等级
      * 
      * 存储风力强度信息，如"3-4级"、"微风"等。
      */
-    QString mFl;
+    QStringView mFl;
     
     // ========== 空气质量信息 ==========
     /**
@@ -118,21 +137,28 @@ public:
      * 
      * 存储PM2.5浓度数值，用于评估空气中细颗粒物污染程度。
      */
-    QString mPm25;
+    QStringView mPm25;
     
     /**
      * @brief 湿度
      * 
      * 存储相对湿度百分比，如"65%"。
      */
-    QString mHu;
+    QStringView mHu;
     
     /**
      * @brief 空气质量等级
      * 
      * 存储空气质量评级，如"优"、"良"、"轻度污染"等。
      */
-    QString mAirq;
+    QStringView mAirq;
+    
+    /**
+     * @brief 空气质量等级ID
+     * 
+     * 解析时由mAirq查表得到，界面更新时用于直接索引空气质量样式。
+     */
+    AirQualityId mAirqId;
 
 };
 
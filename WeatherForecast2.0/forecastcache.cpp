@@ -0,0 +1,64 @@
+/**
+ * @file forecastcache.cpp
+ * @brief 天气数据缓存类的实现文件
+ * @author Weather Forecast Team
+ * @date 2025
+ */
+
+#include "forecastcache.h"    // 天气数据缓存类头文件
+
+#include <QDateTime>          // 当前时间
+
+void ForecastCache::insert(const QString &cityCode, const QByteArray &rawData)
+{
+    if(cityCode.isEmpty())
+    {
+        return;
+    }
+
+    // 缓存已满时淘汰最早获取的一项
+    if(mEntries.size() >= kMaxEntries && !mEntries.contains(cityCode))
+    {
+        QHash<QString,Entry>::iterator oldest = mEntries.begin();
+        for(QHash<QString,Entry>::iterator it = mEntries.begin(); it != mEntries.end(); ++it)
+        {
+            if(it.value().fetchedAt < oldest.value().fetchedAt)
+            {
+                oldest = it;
+            }
+        }
+        mEntries.erase(oldest);
+    }
+
+    Entry entry;
+    entry.rawData = rawData;
+    entry.fetchedAt = QDateTime::currentSecsSinceEpoch();
+    mEntries.insert(cityCode, entry);
+}
+
+bool ForecastCache::lookup(const QString &cityCode, int maxAgeSeconds, QByteArray *rawData) const
+{
+    QHash<QString,Entry>::const_iterator it = mEntries.constFind(cityCode);
+    if(it == mEntries.constEnd())
+    {
+        return false;
+    }
+    if(maxAgeSeconds >= 0
+            && QDateTime::currentSecsSinceEpoch() - it.value().fetchedAt > maxAgeSeconds)
+    {
+        return false;
+    }
+    *rawData = it.value().rawData;
+    return true;
+}
+
+bool ForecastCache::isFresh(const QString &cityCode, int maxAgeSeconds) const
+{
+    QByteArray rawData;
+    return lookup(cityCode, maxAgeSeconds, &rawData);
+}
+
+void ForecastCache::clear()
+{
+    mEntries.clear();
+}
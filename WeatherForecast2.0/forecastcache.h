@@ -0,0 +1,73 @@
+/**
+ * @file forecastcache.h
+ * @brief 天气数据缓存类的头文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 该文件定义了ForecastCache类，按城市代码缓存天气API返回的原始数据。
+ * 缓存命中且未过期时直接解析缓存数据，不再发起网络请求；
+ * 离线模式下允许使用已过期的缓存数据。
+ */
+
+#ifndef FORECASTCACHE_H
+#define FORECASTCACHE_H
+
+#include <QByteArray>       // 原始响应数据
+#include <QHash>            // 城市代码到缓存项的映射
+#include <QString>          // Qt字符串类
+
+/**
+ * @class ForecastCache
+ * @brief 按城市代码缓存的天气数据
+ *
+ * 缓存项数量超过上限时淘汰最早获取的一项。
+ * 过期时间由调用方按当前配置快照传入，配置热加载后立即生效。
+ */
+class ForecastCache
+{
+public:
+    /**
+     * @brief 最多缓存的城市数量
+     */
+    static const int kMaxEntries = 32;
+
+    /**
+     * @brief 保存一个城市的天气数据
+     * @param cityCode 城市代码
+     * @param rawData 天气API返回的原始数据
+     */
+    void insert(const QString &cityCode, const QByteArray &rawData);
+
+    /**
+     * @brief 查找一个城市的天气数据
+     * @param cityCode 城市代码
+     * @param maxAgeSeconds 可接受的最大缓存时间（秒），小于0表示不检查过期
+     * @param rawData 命中时写入原始数据
+     * @return 是否命中
+     */
+    bool lookup(const QString &cityCode, int maxAgeSeconds, QByteArray *rawData) const;
+
+    /**
+     * @brief 一个城市的缓存是否存在且未过期
+     */
+    bool isFresh(const QString &cityCode, int maxAgeSeconds) const;
+
+    /**
+     * @brief 清空全部缓存，API版本切换后旧格式的数据不能再使用
+     */
+    void clear();
+
+private:
+    /**
+     * @brief 缓存项
+     */
+    struct Entry
+    {
+        QByteArray rawData;     // 原始响应数据
+        qint64 fetchedAt;       // 获取时间（自1970年起的秒数）
+    };
+
+    QHash<QString,Entry> mEntries;  // 城市代码到缓存项的映射
+};
+
+#endif // FORECASTCACHE_H
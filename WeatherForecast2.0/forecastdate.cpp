@@ -0,0 +1,217 @@
+/**
+ * @file forecastdate.cpp
+ * @brief 天气数据日期工具类的实现文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 日序号与年月日的相互转换使用公历的400年周期直接计算，不查表、不分配内存。
+ */
+
+#include "forecastdate.h"     // 日期工具类头文件
+
+#include <QDate>              // 本地今天的日期
+#include <limits>             // 无效日序号
+
+namespace {
+
+/**
+ * @brief 1970-01-01的儒略日，用于换算QDate
+ */
+const qint64 kJulianDayOf1970 = 2440588;
+
+/**
+ * @brief 两位数字表，kTwoDigits[n * 2]和kTwoDigits[n * 2 + 1]为n的十位和个位
+ */
+constexpr char kTwoDigits[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+/**
+ * @brief 每月天数（平年）
+ */
+constexpr int kMonthDays[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+/**
+ * @brief 读取一段十进制数字
+ * @return 数字之后的位置，没有数字或超过maxDigits位时返回nullptr
+ */
+const char *readNumber(const char *p, const char *end, int maxDigits, int *value)
+{
+    int result = 0;
+    int digits = 0;
+    while(p < end && *p >= '0' && *p <= '9')
+    {
+        if(++digits > maxDigits)
+        {
+            return nullptr;
+        }
+        result = result * 10 + (*p - '0');
+        p++;
+    }
+    *value = result;
+    return digits > 0 ? p : nullptr;
+}
+
+/**
+ * @brief 将两位数字写入字符缓冲区
+ */
+void writeTwoDigits(QChar *out, int value)
+{
+    out[0] = QLatin1Char(kTwoDigits[value * 2]);
+    out[1] = QLatin1Char(kTwoDigits[value * 2 + 1]);
+}
+
+} // namespace
+
+const qint32 ForecastDate::kInvalidDay = std::numeric_limits<qint32>::min();
+
+qint32 ForecastDate::fromUtf8(const char *data, int size)
+{
+    const char *end = data + size;
+    int year = 0;
+    int month = 0;
+    int day = 0;
+    const char *p = readNumber(data, end, 4, &year);
+    if(!p || p >= end || *p != '-')
+    {
+        return kInvalidDay;
+    }
+    p = readNumber(p + 1, end, 2, &month);
+    if(!p || p >= end || *p != '-')
+    {
+        return kInvalidDay;
+    }
+    p = readNumber(p + 1, end, 2, &day);
+    if(!p || p != end || month < 1 || month > 12 || day < 1)
+    {
+        return kInvalidDay;
+    }
+
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    int monthDays = kMonthDays[month - 1] + (month == 2 && leap ? 1 : 0);
+    if(day > monthDays)
+    {
+        return kInvalidDay;
+    }
+    return fromCivil(year, month, day);
+}
+
+qint32 ForecastDate::fromCivil(int year, int month, int day)
+{
+    // 把3月作为一年的第一个月，闰日落在年末，每月的起始天数可以用线性公式计算
+    year -= month <= 2 ? 1 : 0;
+    int era = (year >= 0 ? year : year - 399) / 400;
+    int yearOfEra = year - era * 400;
+    int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+void ForecastDate::toCivil(qint32 dayNumber, int *year, int *month, int *day)
+{
+    qint32 z = dayNumber + 719468;
+    int era = (z >= 0 ? z : z - 146096) / 146097;
+    int dayOfEra = z - era * 146097;
+    int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int monthIndex = (5 * dayOfYear + 2) / 153;
+    *day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    *month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    *year = yearOfEra + era * 400 + (*month <= 2 ? 1 : 0);
+}
+
+qint32 ForecastDate::today()
+{
+    return static_cast<qint32>(QDate::currentDate().toJulianDay() - kJulianDayOf1970);
+}
+
+int ForecastDate::weekday(qint32 dayNumber)
+{
+    // 1970-01-01是星期四
+    return ((dayNumber % 7) + 7 + 3) % 7;
+}
+
+QString ForecastDate::formatDate(qint32 dayNumber)
+{
+    if(dayNumber == kInvalidDay)
+    {
+        return QString();
+    }
+    int year = 0;
+    int month = 0;
+    int day = 0;
+    toCivil(dayNumber, &year, &month, &day);
+    if(year < 0 || year > 9999)
+    {
+        return QString();
+    }
+
+    QString text(10, Qt::Uninitialized);
+    QChar *out = text.data();
+    writeTwoDigits(out, year / 100);
+    writeTwoDigits(out + 2, year % 100);
+    out[4] = QLatin1Char('-');
+    writeTwoDigits(out + 5, month);
+    out[7] = QLatin1Char('-');
+    writeTwoDigits(out + 8, day);
+    return text;
+}
+
+QString ForecastDate::formatMonthDay(qint32 dayNumber)
+{
+    if(dayNumber == kInvalidDay)
+    {
+        return QString();
+    }
+    int year = 0;
+    int month = 0;
+    int day = 0;
+    toCivil(dayNumber, &year, &month, &day);
+
+    QString text(5, Qt::Uninitialized);
+    QChar *out = text.data();
+    writeTwoDigits(out, month);
+    out[2] = QLatin1Char('-');
+    writeTwoDigits(out + 3, day);
+    return text;
+}
+
+QString ForecastDate::weekdayName(qint32 dayNumber)
+{
+    // QStringLiteral的数据在编译期生成，复制时不分配内存
+    static const QString kNames[] = {
+        QStringLiteral("星期一"), QStringLiteral("星期二"), QStringLiteral("星期三"),
+        QStringLiteral("星期四"), QStringLiteral("星期五"), QStringLiteral("星期六"),
+        QStringLiteral("星期日"),
+    };
+    if(dayNumber == kInvalidDay)
+    {
+        return QString();
+    }
+    return kNames[weekday(dayNumber)];
+}
+
+QString ForecastDate::relativeName(qint32 dayNumber, qint32 today)
+{
+    static const QString kNames[] = {
+        QStringLiteral("今天"), QStringLiteral("明天"), QStringLiteral("后天"),
+    };
+    if(dayNumber == kInvalidDay)
+    {
+        return QString();
+    }
+    qint64 offset = static_cast<qint64>(dayNumber) - today;
+    if(offset >= 0 && offset < 3)
+    {
+        return kNames[offset];
+    }
+    return weekdayName(dayNumber);
+}
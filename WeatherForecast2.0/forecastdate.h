@@ -0,0 +1,87 @@
+/**
+ * @file forecastdate.h
+ * @brief 天气数据日期工具类的头文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 该文件定义了ForecastDate类。天气响应中的日期在扫描后直接由原始字节转换为
+ * 日序号（自1970-01-01起的天数），星期和"今天/明天/后天"由日序号在本地推算，
+ * 显示用的文字通过预先计算的表格式化，不再保存和拆分日期字符串，
+ * 也不再需要响应中的week字段。
+ */
+
+#ifndef FORECASTDATE_H
+#define FORECASTDATE_H
+
+#include <QString>      // 格式化结果
+#include <QtGlobal>     // qint32
+
+/**
+ * @class ForecastDate
+ * @brief 日序号的解析、推算和格式化
+ */
+class ForecastDate
+{
+public:
+    /**
+     * @brief 无效日序号，响应中没有日期或日期格式错误时使用
+     */
+    static const qint32 kInvalidDay;
+
+    /**
+     * @brief 将"YYYY-MM-DD"格式的UTF-8日期转换为日序号
+     * @param data UTF-8数据，不要求以'\0'结尾
+     * @param size 字节数
+     * @return 日序号，格式错误或日期不存在时返回kInvalidDay
+     *
+     * 月和日也接受一位数字，如"2025-6-1"。
+     */
+    static qint32 fromUtf8(const char *data, int size);
+
+    /**
+     * @brief 由年月日计算日序号，参数必须是存在的日期
+     */
+    static qint32 fromCivil(int year, int month, int day);
+
+    /**
+     * @brief 本地时间今天的日序号
+     */
+    static qint32 today();
+
+    /**
+     * @brief 日序号对应的星期
+     * @return 0表示星期一，6表示星期日
+     */
+    static int weekday(qint32 dayNumber);
+
+    /**
+     * @brief 格式化为"YYYY-MM-DD"，无效日序号返回空字符串
+     */
+    static QString formatDate(qint32 dayNumber);
+
+    /**
+     * @brief 格式化为"MM-DD"，无效日序号返回空字符串
+     */
+    static QString formatMonthDay(qint32 dayNumber);
+
+    /**
+     * @brief 星期名称，如"星期一"，无效日序号返回空字符串
+     */
+    static QString weekdayName(qint32 dayNumber);
+
+    /**
+     * @brief 相对于今天的名称
+     * @param dayNumber 日序号
+     * @param today 今天的日序号
+     * @return 今天、明天、后天分别返回"今天"、"明天"、"后天"，其余日期返回星期名称
+     */
+    static QString relativeName(qint32 dayNumber, qint32 today);
+
+private:
+    /**
+     * @brief 由日序号计算年月日
+     */
+    static void toCivil(qint32 dayNumber, int *year, int *month, int *day);
+};
+
+#endif // FORECASTDATE_H
@@ -0,0 +1,140 @@
+/**
+ * @file forecastdiff.cpp
+ * @brief 天气数据增量类的实现文件
+ * @author Weather Forecast Team
+ * @date 2025
+ */
+
+#include "forecastdiff.h"     // 天气数据增量类头文件
+
+// 所有字段对应的位掩码
+static const quint16 kAllFields = static_cast<quint16>((1u << FieldCount) - 1);
+
+/**
+ * @brief 比较两天的同一个字段
+ */
+static bool sameField(const Day &a, const Day &b, int field)
+{
+    switch(field)
+    {
+    case FieldCity:             return a.mCity == b.mCity;
+    case FieldPm25:             return a.mPm25 == b.mPm25;
+    case FieldDate:             return a.mDayNumber == b.mDayNumber;
+    case FieldWeatherType:      return a.mWeathType == b.mWeathType;
+    case FieldTemp:             return a.mTemp == b.mTemp;
+    case FieldTempHigh:         return a.mTempHigh == b.mTempHigh;
+    case FieldTempLow:          return a.mTempLow == b.mTempLow;
+    case FieldWindDirection:    return a.mFx == b.mFx;
+    case FieldWindSpeed:        return a.mFl == b.mFl;
+    case FieldAirQuality:       return a.mAirq == b.mAirq;
+    case FieldTips:             return a.mTips == b.mTips;
+    case FieldHumidity:         return a.mHu == b.mHu;
+    default:                    return true;
+    }
+}
+
+ForecastDiff::ForecastDiff()
+{
+    for(int day = 0; day < ForecastIndex::kMaxDays; day++)
+    {
+        mChanged[day] = 0;
+    }
+}
+
+ForecastDiff ForecastDiff::full()
+{
+    ForecastDiff diff;
+    for(int day = 0; day < ForecastIndex::kMaxDays; day++)
+    {
+        diff.mChanged[day] = kAllFields;
+    }
+    return diff;
+}
+
+ForecastDiff ForecastDiff::compute(const ForecastRecord *previous, const ForecastRecord &current)
+{
+    if(!previous)
+    {
+        return full();
+    }
+
+    // 同一份快照（如缓存命中时取回的快照）不需要逐字段比较
+    ForecastDiff diff;
+    if(previous == &current)
+    {
+        return diff;
+    }
+
+    // 超出响应天数的字段都是空文字，天数变化自然体现为这些字段的变化
+    for(int day = 0; day < ForecastIndex::kMaxDays; day++)
+    {
+        const Day &a = previous->day(day);
+        const Day &b = current.day(day);
+        for(int field = 0; field < FieldCount; field++)
+        {
+            if(!sameField(a, b, field))
+            {
+                diff.mChanged[day] |= static_cast<quint16>(1u << field);
+            }
+        }
+    }
+    return diff;
+}
+
+bool ForecastDiff::isEmpty() const
+{
+    for(int day = 0; day < ForecastIndex::kMaxDays; day++)
+    {
+        if(mChanged[day])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ForecastDiff::contains(int day, ForecastField field) const
+{
+    if(day < 0 || day >= ForecastIndex::kMaxDays)
+    {
+        return false;
+    }
+    return mChanged[day] & (1u << field);
+}
+
+bool ForecastDiff::containsDay(int day) const
+{
+    if(day < 0 || day >= ForecastIndex::kMaxDays)
+    {
+        return false;
+    }
+    return mChanged[day] != 0;
+}
+
+bool ForecastDiff::containsField(ForecastField field) const
+{
+    for(int day = 0; day < ForecastIndex::kMaxDays; day++)
+    {
+        if(mChanged[day] & (1u << field))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int ForecastDiff::count() const
+{
+    int count = 0;
+    for(int day = 0; day < ForecastIndex::kMaxDays; day++)
+    {
+        for(int field = 0; field < FieldCount; field++)
+        {
+            if(mChanged[day] & (1u << field))
+            {
+                count++;
+            }
+        }
+    }
+    return count;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file forecastdiff.h
+ * @brief 天气数据增量类的头文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 该文件定义了ForecastDiff类，记录同一城市前后两份天气数据快照之间
+ * 哪些天的哪些字段发生了变化。定时刷新时大部分数据不变，
+ * 使用者只需处理增量中标记的字段，没有变化时不做任何处理。
+ */
+
+#ifndef FORECASTDIFF_H
+#define FORECASTDIFF_H
+
+#include "forecastrecord.h"     // 天气数据快照
+
+#include <QMetaType>            // 跨线程信号传递
+
+/**
+ * @class ForecastDiff
+ * @brief 字段级的天气数据增量
+ *
+ * 每天一个位掩码，第field位表示该天的字段发生了变化，共kMaxDays个quint16，
+ * 可以按值复制和跨线程传递。
+ * 日期按日序号比较，天气类型和空气质量按文字比较（ID由文字决定），
+ * 温度按文字比较（数值由文字决定）。
+ */
+class ForecastDiff
+{
+public:
+    /**
+     * @brief 创建没有任何变化的增量
+     */
+    ForecastDiff();
+
+    /**
+     * @brief 所有天的所有字段都标记为变化，用于首次显示或切换城市
+     */
+    static ForecastDiff full();
+
+    /**
+     * @brief 比较前后两份快照
+     * @param previous 之前的快照，为nullptr时返回full()
+     * @param current 新的快照
+     */
+    static ForecastDiff compute(const ForecastRecord *previous, const ForecastRecord &current);
+
+    /**
+     * @brief 是否没有任何变化
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief 某一天的某个字段是否变化
+     */
+    bool contains(int day, ForecastField field) const;
+
+    /**
+     * @brief 某一天是否有任何字段变化
+     */
+    bool containsDay(int day) const;
+
+    /**
+     * @brief 是否有任何一天的某个字段变化
+     */
+    bool containsField(ForecastField field) const;
+
+    /**
+     * @brief 变化的字段总数，用于调试统计
+     */
+    int count() const;
+
+private:
+    quint16 mChanged[ForecastIndex::kMaxDays];  // 每天变化字段的位掩码
+};
+
+Q_DECLARE_METATYPE(ForecastDiff)
+
+#endif // FORECASTDIFF_H
@@ -0,0 +1,687 @@
+/**
+ * @file forecastparser.cpp
+ * @brief 天气响应解析类的实现文件
+ * @author Weather Forecast Team
+ * @date 2025
+ */
+
+#include "forecastparser.h"   // 天气响应解析类头文件
+#include "jsonscan.h"         // JSON字节扫描
+
+#include <QAtomicInt>         // 各类错误的计数器，可在多个线程中同时扫描
+
+// x86-64总是支持SSE2；32位MSVC需要/arch:SSE2
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>        // SSE2：16字节一组解码ASCII
+#define FORECAST_PARSER_SSE2
+#endif
+
+ForecastIndex::ForecastIndex()
+    : dayCount(0)
+{
+    errorCode.offset = 0;
+    errorCode.length = 0;
+    errorCode.escaped = false;
+    errorMessage = errorCode;
+    for(int day = 0; day < kMaxDays; day++)
+    {
+        for(int field = 0; field < FieldCount; field++)
+        {
+            fields[day][field].offset = 0;
+            fields[day][field].length = 0;
+            fields[day][field].escaped = false;
+        }
+    }
+}
+
+/**
+ * @brief 将UTF-8内容解码为UTF-16
+ * @param out 输出缓冲区，至少end - p个字符
+ * @return 写入的字符数，遇到无效的转义时返回-1
+ *
+ * 字符数不会超过字节数：多字节序列和转义序列都解码为更少的UTF-16字符，
+ * 因此可以按字节数预先分配。无效的UTF-8序列解码为U+FFFD。
+ *
+ * 日期、温度等字段全是ASCII，SSE2下每次检查16字节，没有非ASCII字节和反斜杠时
+ * 直接零扩展写出；天气类型、风向等短中文字段几乎都是3字节序列，单独走一条
+ * 不需要计算序列长度的分支。
+ */
+static int decodeText(const char *p, const char *end, ushort *out)
+{
+    const uchar *s = reinterpret_cast<const uchar *>(p);
+    const uchar *stop = reinterpret_cast<const uchar *>(end);
+    int size = 0;
+    while(s < stop)
+    {
+#ifdef FORECAST_PARSER_SSE2
+        if(stop - s >= 16)
+        {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s));
+            __m128i backslash = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'));
+            if(_mm_movemask_epi8(_mm_or_si128(chunk, backslash)) == 0)
+            {
+                __m128i zero = _mm_setzero_si128();
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + size), _mm_unpacklo_epi8(chunk, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + size + 8), _mm_unpackhi_epi8(chunk, zero));
+                size += 16;
+                s += 16;
+                continue;
+            }
+        }
+#endif
+        uint c = *s;
+        if(c < 0x80 && c != '\\')
+        {
+            out[size++] = static_cast<ushort>(c);
+            s++;
+            continue;
+        }
+
+        // 3字节序列（CJK汉字）：后续字节合法、不是过长编码也不是代理区时直接写出
+        if((c & 0xF0) == 0xE0 && stop - s >= 3 && (s[1] & 0xC0) == 0x80 && (s[2] & 0xC0) == 0x80)
+        {
+            uint value = ((c & 0x0F) << 12) | ((s[1] & 0x3Fu) << 6) | (s[2] & 0x3Fu);
+            if(value >= 0x800 && (value < 0xD800 || value > 0xDFFF))
+            {
+                out[size++] = static_cast<ushort>(value);
+                s += 3;
+                continue;
+            }
+        }
+
+        uint codePoint = 0xFFFD;
+        if(c == '\\')
+        {
+            if(stop - s < 2)
+            {
+                return -1;
+            }
+            char escape = static_cast<char>(s[1]);
+            s += 2;
+            switch(escape)
+            {
+            case '"':  codePoint = '"';  break;
+            case '\\': codePoint = '\\'; break;
+            case '/':  codePoint = '/';  break;
+            case 'b':  codePoint = '\b'; break;
+            case 'f':  codePoint = '\f'; break;
+            case 'n':  codePoint = '\n'; break;
+            case 'r':  codePoint = '\r'; break;
+            case 't':  codePoint = '\t'; break;
+            case 'u':
+            {
+                const char *hex = reinterpret_cast<const char *>(s);
+                if(!JsonScan::parseHex4(hex, end, &codePoint))
+                {
+                    return -1;
+                }
+                s += 4;
+                // \u转义本身就是UTF-16，代理对原样写出
+                out[size++] = static_cast<ushort>(codePoint);
+                continue;
+            }
+            default:
+                return -1;
+            }
+        }
+        else
+        {
+            // 多字节序列：按首字节确定长度，检查后续字节和过长编码
+            int length = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+            uint minimum = length == 4 ? 0x10000 : length == 3 ? 0x800 : 0x80;
+            uint value = length == 4 ? (c & 0x07) : length == 3 ? (c & 0x0F) : (c & 0x1F);
+            bool valid = length > 1 && stop - s >= length;
+            for(int i = 1; valid && i < length; i++)
+            {
+                valid = (s[i] & 0xC0) == 0x80;
+                value = (value << 6) | (s[i] & 0x3F);
+            }
+            if(valid && value >= minimum && value <= 0x10FFFF && (value < 0xD800 || value > 0xDFFF))
+            {
+                codePoint = value;
+                s += length;
+            }
+            else
+            {
+                s++;
+            }
+        }
+
+        if(codePoint >= 0x10000)
+        {
+            out[size++] = QChar::highSurrogate(codePoint);
+            out[size++] = QChar::lowSurrogate(codePoint);
+        }
+        else
+        {
+            out[size++] = static_cast<ushort>(codePoint);
+        }
+    }
+    return size;
+}
+
+/**
+ * @brief 检查字符串内容中的转义字符是否合法
+ *
+ * 只对含有转义字符的字段调用，扫描时发现格式错误，解码时就不会失败。
+ */
+static bool validEscapes(const char *p, const char *end)
+{
+    while(p < end)
+    {
+        if(*p != '\\')
+        {
+            p++;
+            continue;
+        }
+        if(end - p < 2)
+        {
+            return false;
+        }
+        switch(p[1])
+        {
+        case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+            p += 2;
+            break;
+        case 'u':
+        {
+            uint value;
+            if(!JsonScan::parseHex4(p + 2, end, &value))
+            {
+                return false;
+            }
+            p += 6;
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 记录一个字符串字段的位置，不解码
+ * @param begin 原始数据的开头，用于计算偏移
+ * @param error 转义字符非法时写入ForecastBadEscape
+ * @return 值之后的位置，格式错误时返回nullptr
+ */
+static const char *scanText(const char *p, const char *begin, const char *end, FieldSpan *span, ForecastError *error)
+{
+    span->offset = 0;
+    span->length = 0;
+    span->escaped = false;
+    if(p >= end || *p != '"')
+    {
+        // 非字符串的值按空文字处理
+        return JsonScan::skipValue(p, end);
+    }
+
+    bool escaped = false;
+    const char *next = JsonScan::skipString(p, end, &escaped);
+    if(!next)
+    {
+        return nullptr;
+    }
+    if(escaped && !validEscapes(p + 1, next - 1))
+    {
+        *error = ForecastBadEscape;
+        return nullptr;
+    }
+    span->offset = static_cast<int>(p + 1 - begin);
+    span->length = static_cast<int>(next - 1 - (p + 1));
+    span->escaped = escaped;
+    return next;
+}
+
+/**
+ * @brief 遍历一个JSON对象的键值对
+ * @param handler 以(键开头, 键结尾, 值位置)调用，返回值之后的位置或nullptr
+ * @return 对象之后的位置，格式错误时返回nullptr
+ *
+ * 天气响应中的键都是不含转义字符的ASCII，直接比较原始字节。
+ */
+template <typename Handler>
+static const char *parseObject(const char *p, const char *end, Handler handler)
+{
+    if(p >= end || *p != '{')
+    {
+        return nullptr;
+    }
+    p = JsonScan::skipSpace(p + 1, end);
+    while(p && p < end && *p != '}')
+    {
+        if(*p != '"')
+        {
+            return nullptr;
+        }
+        const char *keyBegin = p + 1;
+        p = JsonScan::skipString(p, end);
+        if(!p)
+        {
+            return nullptr;
+        }
+        const char *keyEnd = p - 1;
+        p = JsonScan::skipSpace(p, end);
+        if(p >= end || *p != ':')
+        {
+            return nullptr;
+        }
+        p = handler(keyBegin, keyEnd, JsonScan::skipSpace(p + 1, end));
+        if(!p)
+        {
+            return nullptr;
+        }
+        p = JsonScan::skipSpace(p, end);
+        if(p < end && *p == ',')
+        {
+            p = JsonScan::skipSpace(p + 1, end);
+        }
+    }
+    return p && p < end ? p + 1 : nullptr;
+}
+
+/**
+ * @brief 遍历一个JSON数组的元素
+ * @param handler 以(元素下标, 值位置)调用，返回值之后的位置或nullptr
+ * @return 数组之后的位置，格式错误时返回nullptr
+ */
+template <typename Handler>
+static const char *parseArray(const char *p, const char *end, Handler handler)
+{
+    if(p >= end || *p != '[')
+    {
+        return nullptr;
+    }
+    p = JsonScan::skipSpace(p + 1, end);
+    int index = 0;
+    while(p && p < end && *p != ']')
+    {
+        p = handler(index++, p);
+        if(!p)
+        {
+            return nullptr;
+        }
+        p = JsonScan::skipSpace(p, end);
+        if(p < end && *p == ',')
+        {
+            p = JsonScan::skipSpace(p + 1, end);
+        }
+    }
+    return p && p < end ? p + 1 : nullptr;
+}
+
+/**
+ * @brief 记录一个标量值的原始内容，用于读取errcode
+ *
+ * 字符串记录引号之间的内容，数字等其他标量记录值本身；对象和数组整体跳过。
+ */
+static const char *scanScalar(const char *p, const char *begin, const char *end, FieldSpan *span, ForecastError *error)
+{
+    if(p < end && (*p == '{' || *p == '['))
+    {
+        return JsonScan::skipValue(p, end);
+    }
+    if(p < end && *p == '"')
+    {
+        return scanText(p, begin, end, span, error);
+    }
+    const char *next = JsonScan::skipValue(p, end);
+    if(next)
+    {
+        span->offset = static_cast<int>(p - begin);
+        span->length = static_cast<int>(next - p);
+        span->escaped = false;
+    }
+    return next;
+}
+
+/**
+ * @brief 一条字段规则的匹配进度
+ */
+struct RuleCursor
+{
+    const FieldRule *rule;  // 字段规则
+    const char *segment;    // 路径中尚未匹配的部分，为空串时表示已走到字段本身
+};
+
+/**
+ * @brief 路径当前段的长度
+ */
+static int segmentLength(const char *segment)
+{
+    const char *p = segment;
+    while(*p && *p != '.')
+    {
+        p++;
+    }
+    return static_cast<int>(p - segment);
+}
+
+/**
+ * @brief 跳过路径的当前段
+ */
+static const char *nextSegment(const char *segment)
+{
+    segment += segmentLength(segment);
+    return *segment == '.' ? segment + 1 : segment;
+}
+
+/**
+ * @brief 路径的当前段作为数组下标的值
+ * @return 下标，当前段不是数字时返回-1
+ */
+static int segmentIndex(const char *segment)
+{
+    int length = segmentLength(segment);
+    int value = 0;
+    for(int i = 0; i < length; i++)
+    {
+        if(segment[i] < '0' || segment[i] > '9')
+        {
+            return -1;
+        }
+        value = value * 10 + (segment[i] - '0');
+    }
+    return length > 0 ? value : -1;
+}
+
+/**
+ * @brief 筛选当前段等于键的规则，并前进到下一段
+ * @return 匹配的规则数
+ */
+static int matchKey(const RuleCursor *cursors, int count, const char *keyBegin, const char *keyEnd, RuleCursor *matched)
+{
+    int matchedCount = 0;
+    for(int i = 0; i < count; i++)
+    {
+        if(JsonScan::keyEquals(keyBegin, keyEnd, cursors[i].segment, segmentLength(cursors[i].segment)))
+        {
+            matched[matchedCount].rule = cursors[i].rule;
+            matched[matchedCount].segment = nextSegment(cursors[i].segment);
+            matchedCount++;
+        }
+    }
+    return matchedCount;
+}
+
+/**
+ * @brief 按字段规则扫描一个值
+ * @param cursors 走到该值的规则
+ * @param fields 记录字段位置的一天
+ * @param error 能确定具体原因的格式错误写入此处
+ * @return 值之后的位置，格式错误时返回nullptr
+ *
+ * 路径已走完的规则读取该值本身；否则进入对象或数组继续匹配，
+ * 类型不符（如期望数组却是字符串）时整体跳过，对应字段保持为空。
+ */
+static const char *scanValue(const char *p, const char *begin, const char *end,
+                             const RuleCursor *cursors, int count, FieldSpan *fields, ForecastError *error)
+{
+    for(int i = 0; i < count; i++)
+    {
+        if(*cursors[i].segment == '\0')
+        {
+            return scanText(p, begin, end, &fields[cursors[i].rule->field], error);
+        }
+    }
+
+    if(p < end && *p == '{')
+    {
+        return parseObject(p, end, [begin, end, cursors, count, fields, error](const char *keyBegin, const char *keyEnd, const char *value) -> const char * {
+            RuleCursor matched[ForecastSchema::kMaxRules];
+            int matchedCount = matchKey(cursors, count, keyBegin, keyEnd, matched);
+            return matchedCount > 0 ? scanValue(value, begin, end, matched, matchedCount, fields, error)
+                                    : JsonScan::skipValue(value, end);
+        });
+    }
+    if(p < end && *p == '[')
+    {
+        return parseArray(p, end, [begin, end, cursors, count, fields, error](int index, const char *element) -> const char * {
+            RuleCursor matched[ForecastSchema::kMaxRules];
+            int matchedCount = 0;
+            for(int i = 0; i < count; i++)
+            {
+                if(segmentIndex(cursors[i].segment) == index)
+                {
+                    matched[matchedCount].rule = cursors[i].rule;
+                    matched[matchedCount].segment = nextSegment(cursors[i].segment);
+                    matchedCount++;
+                }
+            }
+            return matchedCount > 0 ? scanValue(element, begin, end, matched, matchedCount, fields, error)
+                                    : JsonScan::skipValue(element, end);
+        });
+    }
+    return JsonScan::skipValue(p, end);
+}
+
+/**
+ * @brief 为一组字段规则建立初始的匹配进度
+ * @return 追加后的规则数
+ */
+static int appendCursors(const FieldRule *rules, int ruleCount, RuleCursor *cursors, int count)
+{
+    for(int i = 0; i < ruleCount; i++)
+    {
+        cursors[count].rule = &rules[i];
+        cursors[count].segment = rules[i].path;
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief 检查一天中格式标记为必需的字段是否都有值
+ */
+static bool hasRequiredFields(const FieldRule *rules, int ruleCount, const FieldSpan *fields)
+{
+    for(int i = 0; i < ruleCount; i++)
+    {
+        if(rules[i].required && fields[rules[i].field].length == 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 各类扫描错误发生的次数
+ */
+static QAtomicInt sErrorCounts[ForecastErrorCount];
+
+ForecastError ForecastParser::scan(const QByteArray &rawData, const ForecastSchema &schema, ForecastIndex *index)
+{
+    *index = ForecastIndex();
+    const char *begin = rawData.constData();
+    const char *end = begin + rawData.size();
+    const char *p = JsonScan::skipSpace(begin, end);
+    ForecastError error = ForecastOk;
+
+    // 只有当天实况的版本中每天的字段也在根对象里，结果固定为一天
+    RuleCursor rootCursors[ForecastSchema::kMaxRules];
+    RuleCursor dayCursors[ForecastSchema::kMaxRules];
+    int rootCount = appendCursors(schema.rootRules, schema.rootRuleCount, rootCursors, 0);
+    int dayCount = appendCursors(schema.dayRules, schema.dayRuleCount, dayCursors, 0);
+    if(!schema.daysKey)
+    {
+        rootCount = appendCursors(schema.dayRules, schema.dayRuleCount, rootCursors, rootCount);
+        index->dayCount = 1;
+    }
+    int daysKeyLength = schema.daysKey ? segmentLength(schema.daysKey) : 0;
+
+    p = parseObject(p, end, [&](const char *keyBegin, const char *keyEnd, const char *value) -> const char * {
+        // 错误对象的键与API版本无关，在同一遍扫描中记录
+        if(JsonScan::keyEquals(keyBegin, keyEnd, "errcode", 7))
+        {
+            return scanScalar(value, begin, end, &index->errorCode, &error);
+        }
+        if(JsonScan::keyEquals(keyBegin, keyEnd, "errmsg", 6))
+        {
+            return scanText(value, begin, end, &index->errorMessage, &error);
+        }
+
+        if(schema.daysKey && JsonScan::keyEquals(keyBegin, keyEnd, schema.daysKey, daysKeyLength)
+                && value < end && *value == '[')
+        {
+            return parseArray(value, end, [&](int day, const char *element) -> const char * {
+                // 超出容量的天数和非对象的元素直接跳过，不会写出索引的范围
+                if(day >= ForecastIndex::kMaxDays || *element != '{')
+                {
+                    return JsonScan::skipValue(element, end);
+                }
+                index->dayCount = day + 1;
+                return scanValue(element, begin, end, dayCursors, dayCount, index->fields[day], &error);
+            });
+        }
+
+        RuleCursor matched[ForecastSchema::kMaxRules];
+        int matchedCount = matchKey(rootCursors, rootCount, keyBegin, keyEnd, matched);
+        return matchedCount > 0 ? scanValue(value, begin, end, matched, matchedCount, index->fields[0], &error)
+                                : JsonScan::skipValue(value, end);
+    });
+
+    if(!p)
+    {
+        // 转义字符错误在发现时已写入，其余都是结构错误
+        error = error == ForecastOk ? ForecastSyntaxError : error;
+    }
+    else if(index->errorCode.length > 0
+            && !JsonScan::keyEquals(begin + index->errorCode.offset,
+                                    begin + index->errorCode.offset + index->errorCode.length, "0", 1))
+    {
+        error = ForecastApiError;
+    }
+    else if(index->dayCount == 0)
+    {
+        error = ForecastMissingDays;
+    }
+    else
+    {
+        // 必需字段的检查只读取索引，不再遍历原始数据
+        bool valid = hasRequiredFields(schema.rootRules, schema.rootRuleCount, index->fields[0]);
+        for(int day = 0; valid && day < index->dayCount; day++)
+        {
+            valid = hasRequiredFields(schema.dayRules, schema.dayRuleCount, index->fields[day]);
+        }
+        error = valid ? ForecastOk : ForecastMissingField;
+    }
+
+    if(error != ForecastOk)
+    {
+        sErrorCounts[error].ref();
+    }
+    return error;
+}
+
+int ForecastParser::errorCount(ForecastError error)
+{
+    return error > ForecastOk && error < ForecastErrorCount ? sErrorCounts[error].load() : 0;
+}
+
+const char *ForecastParser::errorName(ForecastError error)
+{
+    switch(error)
+    {
+    case ForecastOk:            return "正常";
+    case ForecastSyntaxError:   return "JSON格式错误";
+    case ForecastBadEscape:     return "非法的转义字符";
+    case ForecastApiError:      return "服务器返回错误";
+    case ForecastMissingDays:   return "缺少天气数据";
+    case ForecastMissingField:  return "缺少必需的字段";
+    case ForecastUnknownVersion: return "不支持的API版本";
+    default:                    return "未知错误";
+    }
+}
+
+QStringView ForecastParser::decode(const QByteArray &rawData, const FieldSpan &span, ParseArena *arena)
+{
+    if(span.length == 0)
+    {
+        return QStringView();
+    }
+
+    // 按字节数分配上限，解码后归还未使用的部分
+    const char *raw = rawData.constData() + span.offset;
+    int capacity = span.length;
+    QChar *chars = arena->allocateChars(capacity);
+    int size = decodeText(raw, raw + span.length, reinterpret_cast<ushort *>(chars));
+    if(size < 0)
+    {
+        // 转义字符在扫描时已检查，只有传入了不匹配的原始数据才会走到这里
+        size = 0;
+    }
+    arena->shrinkLast(chars, capacity * static_cast<int>(sizeof(QChar)), size * static_cast<int>(sizeof(QChar)));
+    return QStringView(chars, size);
+}
+
+void ForecastParser::utf8(const QByteArray &rawData, const FieldSpan &span, QStringView text,
+                          QVarLengthArray<char, 64> *out)
+{
+    out->clear();
+    if(!span.escaped)
+    {
+        out->append(rawData.constData() + span.offset, span.length);
+        return;
+    }
+    const ushort *chars = reinterpret_cast<const ushort *>(text.utf16());
+    int length = static_cast<int>(text.size());
+    for(int i = 0; i < length; i++)
+    {
+        uint c = chars[i];
+        if(QChar::isHighSurrogate(c) && i + 1 < length && QChar::isLowSurrogate(chars[i + 1]))
+        {
+            c = QChar::surrogateToUcs4(static_cast<ushort>(c), chars[++i]);
+        }
+        if(c < 0x80)
+        {
+            out->append(static_cast<char>(c));
+        }
+        else if(c < 0x800)
+        {
+            out->append(static_cast<char>(0xC0 | (c >> 6)));
+            out->append(static_cast<char>(0x80 | (c & 0x3F)));
+        }
+        else if(c < 0x10000)
+        {
+            out->append(static_cast<char>(0xE0 | (c >> 12)));
+            out->append(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+            out->append(static_cast<char>(0x80 | (c & 0x3F)));
+        }
+        else
+        {
+            out->append(static_cast<char>(0xF0 | (c >> 18)));
+            out->append(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
+            out->append(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+            out->append(static_cast<char>(0x80 | (c & 0x3F)));
+        }
+    }
+}
+
+int ForecastParser::toInt(QStringView text)
+{
+    int i = 0;
+    int length = static_cast<int>(text.size());
+    bool negative = false;
+    if(i < length && (text[i] == QLatin1Char('-') || text[i] == QLatin1Char('+')))
+    {
+        negative = text[i] == QLatin1Char('-');
+        i++;
+    }
+    if(i == length)
+    {
+        return 0;
+    }
+    int value = 0;
+    for(; i < length; i++)
+    {
+        ushort c = text[i].unicode();
+        if(c < '0' || c > '9')
+        {
+            return 0;
+        }
+        value = value * 10 + (c - '0');
+    }
+    return negative ? -value : value;
+}
@@ -0,0 +1,125 @@
+/**
+ * @file forecastparser.h
+ * @brief 天气响应解析类的头文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 该文件定义了ForecastParser类，按API版本的响应格式（ForecastSchema）
+ * 在原始字节上一遍扫描天气API的响应，
+ * 只记录界面需要的字段在原始数据中的位置（ForecastIndex），不解码文字；
+ * 字段在首次使用时才由decode解码，解码后的文字直接写入ParseArena。
+ * 扫描和解码都不构造QJsonDocument、QJsonObject和QString。
+ */
+
+#ifndef FORECASTPARSER_H
+#define FORECASTPARSER_H
+
+#include "forecastschema.h" // 各API版本的响应格式
+#include "parsearena.h"     // 解析内存池
+
+#include <QByteArray>       // 原始响应数据
+#include <QStringView>      // 解码后的文字
+#include <QVarLengthArray>  // 字段的UTF-8内容
+
+/**
+ * @brief 天气响应的扫描结果
+ *
+ * 所有检查都在同一遍扫描中完成：结构和转义错误在发现时立即停止扫描，
+ * 错误对象、天数和必需字段在扫描结束后只检查索引。
+ */
+enum ForecastError
+{
+    ForecastOk,             // 扫描成功
+    ForecastSyntaxError,    // 不是完整的JSON对象（截断、缺少引号或括号等）
+    ForecastBadEscape,      // 字符串含有非法的转义字符
+    ForecastApiError,       // 服务器返回了错误对象（errcode不为0）
+    ForecastMissingDays,    // 缺少每天数据的数组，或数组中没有任何一天
+    ForecastMissingField,   // 某一天缺少响应格式中标记为必需的字段
+    ForecastUnknownVersion, // 请求的API版本没有对应的响应格式，由调用方设置，扫描不会返回
+    ForecastErrorCount
+};
+
+/**
+ * @brief 一个字符串字段在原始数据中的位置
+ *
+ * 记录的是引号之间的原始内容；缺少的字段和非字符串的值长度为0，
+ * 解码为空文字，与QJsonValue::toString的行为一致。
+ */
+struct FieldSpan
+{
+    int offset;             // 内容开头相对于原始数据的偏移
+    int length;             // 内容的字节数
+    bool escaped;           // 内容是否含有转义字符
+};
+
+/**
+ * @brief 一次天气响应的字段位置索引
+ */
+struct ForecastIndex
+{
+    static const int kMaxDays = 7;  // 最多记录的天数，多出的天数被忽略
+
+    ForecastIndex();
+
+    int dayCount;                               // 记录的天数，只有当天实况的版本为1
+    FieldSpan fields[kMaxDays][FieldCount];     // 每天每个字段的位置
+    FieldSpan errorCode;                        // 错误对象的errcode，数字时为数字本身
+    FieldSpan errorMessage;                     // 错误对象的errmsg
+};
+
+/**
+ * @class ForecastParser
+ * @brief 天气API响应的单遍扫描器和按需解码器
+ *
+ * 扫描只确定字段的位置并检查转义字符是否合法，
+ * 因此格式错误在扫描时即可发现，之后的解码不会失败。
+ * 扫描失败的响应不应写入缓存或显示，各类错误的次数可由errorCount查询。
+ */
+class ForecastParser
+{
+public:
+    /**
+     * @brief 扫描一次天气响应，记录各字段的位置
+     * @param rawData 天气API返回的原始数据
+     * @param schema 请求时使用的API版本的响应格式
+     * @param index 输出的字段位置索引
+     * @return 扫描结果；data数组超过kMaxDays天时只记录前kMaxDays天，不算错误
+     */
+    static ForecastError scan(const QByteArray &rawData, const ForecastSchema &schema, ForecastIndex *index);
+
+    /**
+     * @brief 一类扫描错误累计发生的次数，可在任意线程调用
+     */
+    static int errorCount(ForecastError error);
+
+    /**
+     * @brief 扫描错误的名称，用于日志
+     */
+    static const char *errorName(ForecastError error);
+
+    /**
+     * @brief 解码一个字段的文字
+     * @param rawData 扫描时使用的原始数据
+     * @param span 字段的位置
+     * @param arena 解码后的文字写入该内存池，在内存池释放前有效
+     */
+    static QStringView decode(const QByteArray &rawData, const FieldSpan &span, ParseArena *arena);
+
+    /**
+     * @brief 获取字段的UTF-8内容，用于查找天气类型和空气质量ID
+     * @param text 字段含有转义字符时使用的已解码文字
+     *
+     * 没有转义字符时直接复制原始数据，不需要先解码；
+     * 含有转义字符时（如"\u6674"）由解码后的文字重新编码。
+     */
+    static void utf8(const QByteArray &rawData, const FieldSpan &span, QStringView text,
+                     QVarLengthArray<char, 64> *out);
+
+    /**
+     * @brief 将温度文字转换为整数
+     * @return 整数值，文字不是完整的整数时返回0，与QString::toInt一致
+     */
+    static int toInt(QStringView text);
+};
+
+#endif // FORECASTPARSER_H
@@ -0,0 +1,54 @@
+/**
+ * @file forecastrecord.cpp
+ * @brief 不可变天气数据类的实现文件
+ * @author Weather Forecast Team
+ * @date 2025
+ */
+
+#include "forecastrecord.h"   // 不可变天气数据类头文件
+#include "recordpool.h"       // 按线程缓存的对象内存
+
+// 超出范围的天数返回的空数据，只读，可在任意线程使用
+static const Day kEmptyDay;
+
+ForecastRecord::ForecastRecord()
+    : mDayCount(0)
+{
+}
+
+void *ForecastRecord::operator new(size_t size)
+{
+    return RecordPool<ForecastRecord>::allocate(size);
+}
+
+void ForecastRecord::operator delete(void *block, size_t size)
+{
+    RecordPool<ForecastRecord>::release(block, size);
+}
+
+ForecastSnapshot ForecastRecord::fromForecast(const QSharedPointer<LazyForecast> &forecast)
+{
+    // 所有解码都在发布之前完成；响应中缺少的天数由LazyForecast返回空文字
+    ForecastRecord *record = new ForecastRecord;
+    record->mSource = forecast;
+    record->mDayCount = forecast->dayCount();
+    for(int i = 0; i < ForecastIndex::kMaxDays; i++)
+    {
+        record->mDays[i] = forecast->day(i);
+    }
+    return ForecastSnapshot(record);
+}
+
+int ForecastRecord::dayCount() const
+{
+    return mDayCount;
+}
+
+const Day &ForecastRecord::day(int index) const
+{
+    if(index < 0 || index >= ForecastIndex::kMaxDays)
+    {
+        return kEmptyDay;
+    }
+    return mDays[index];
+}
@@ -0,0 +1,81 @@
+/**
+ * @file forecastrecord.h
+ * @brief 不可变天气数据类的头文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 该文件定义了ForecastRecord类和ForecastSnapshot类型。ForecastRecord在创建时
+ * 一次性取出LazyForecast的全部字段，之后不再修改，
+ * 界面、温度曲线、缓存和其他使用者可以在任意线程同时持有和读取同一个快照，
+ * 不需要复制，也不需要加锁。
+ */
+
+#ifndef FORECASTRECORD_H
+#define FORECASTRECORD_H
+
+#include "day.h"                // 单日天气数据
+#include "lazyforecast.h"       // 按需解码的天气数据
+
+#include <QSharedPointer>       // 共享所有权
+#include <QMetaType>            // 跨线程信号传递
+
+class ForecastRecord;
+
+/**
+ * @brief 天气数据快照类型
+ *
+ * 指向不可变天气数据的共享指针，持有者在替换发生后仍可安全使用旧快照。
+ */
+typedef QSharedPointer<const ForecastRecord> ForecastSnapshot;
+
+/**
+ * @class ForecastRecord
+ * @brief 不可变的天气数据
+ *
+ * 通过fromForecast创建，创建时在当前线程解码全部天数的全部字段，
+ * Day中的文字指向LazyForecast的内存池。ForecastRecord持有该LazyForecast
+ * 只为保证内存池有效，创建完成后不再调用它的访问函数（它们会写入解码缓存），
+ * 因此快照发布后的所有读取都是只读的。
+ */
+class ForecastRecord
+{
+public:
+    /**
+     * @brief 创建没有任何数据的天气数据，所有字段都是空文字
+     */
+    ForecastRecord();
+
+    /**
+     * @brief 从RecordPool分配和释放，批量刷新时复用已释放对象的内存
+     */
+    static void *operator new(size_t size);
+    static void operator delete(void *block, size_t size);
+
+    /**
+     * @brief 由扫描成功的天气响应创建快照
+     * @param forecast 天气数据，创建后不应再被其他地方访问
+     * @return 不可变的天气数据快照
+     */
+    static ForecastSnapshot fromForecast(const QSharedPointer<LazyForecast> &forecast);
+
+    /**
+     * @brief 响应中的天数，最多ForecastIndex::kMaxDays天
+     */
+    int dayCount() const;
+
+    /**
+     * @brief 获取一天的天气数据
+     * @param index 第几天，超出范围时返回所有字段为空的Day
+     * @return 文字指向本快照持有的内存池，在快照释放前有效
+     */
+    const Day &day(int index) const;
+
+private:
+    QSharedPointer<const LazyForecast> mSource; // 持有解码后文字所在的内存池
+    int mDayCount;                              // 响应中的天数
+    Day mDays[ForecastIndex::kMaxDays];         // 每天的全部字段
+};
+
+Q_DECLARE_METATYPE(ForecastSnapshot)
+
+#endif // FORECASTRECORD_H
@@ -0,0 +1,100 @@
+/**
+ * @file forecastschema.cpp
+ * @brief 天气API响应格式描述的实现文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 各版本的字段表以constexpr数组的形式存放在只读数据段中，程序启动时不做任何初始化。
+ * 新增版本时在kSchemas中增加一项即可。
+ */
+
+#include "forecastschema.h"   // 响应格式头文件
+
+#include <QStringList>        // 拼接支持的版本列表
+
+namespace {
+
+/**
+ * @brief v9：七天预报，每天的数据在data数组中
+ *
+ * 城市、日期、天气类型和最高最低温度是必需的，缺少时界面无法正常显示。
+ */
+constexpr FieldRule kV9RootRules[] = {
+    { FieldCity, "city", true },
+    { FieldPm25, "aqi.pm25", false },
+};
+
+constexpr FieldRule kV9DayRules[] = {
+    { FieldDate, "date", true },
+    { FieldWeatherType, "wea", true },
+    { FieldTemp, "tem", false },
+    { FieldTempHigh, "tem1", true },
+    { FieldTempLow, "tem2", true },
+    { FieldWindDirection, "win.0", false },
+    { FieldWindSpeed, "win_speed", false },
+    { FieldAirQuality, "air_level", false },
+    { FieldTips, "index.3.desc", false },
+    { FieldHumidity, "humidity", false },
+};
+
+/**
+ * @brief v61：当天实况，响应更小，所有字段都在根对象中；
+ * 没有生活指数，感冒指数为空
+ */
+constexpr FieldRule kV61RootRules[] = {
+    { FieldCity, "city", true },
+    { FieldPm25, "air_pm25", false },
+};
+
+constexpr FieldRule kV61DayRules[] = {
+    { FieldDate, "date", true },
+    { FieldWeatherType, "wea", true },
+    { FieldTemp, "tem", true },
+    { FieldTempHigh, "tem1", false },
+    { FieldTempLow, "tem2", false },
+    { FieldWindDirection, "win", false },
+    { FieldWindSpeed, "win_speed", false },
+    { FieldAirQuality, "air_level", false },
+    { FieldHumidity, "humidity", false },
+};
+
+template <typename T, int N>
+constexpr int countOf(const T (&)[N])
+{
+    return N;
+}
+
+const ForecastSchema kSchemas[] = {
+    { "v9", "data", kV9RootRules, countOf(kV9RootRules), kV9DayRules, countOf(kV9DayRules) },
+    { "v61", nullptr, kV61RootRules, countOf(kV61RootRules), kV61DayRules, countOf(kV61DayRules) },
+};
+
+// 扫描时根对象要同时匹配根字段和当天字段
+static_assert(countOf(kV9RootRules) + countOf(kV9DayRules) <= ForecastSchema::kMaxRules,
+              "v9字段规则超过ForecastSchema::kMaxRules");
+static_assert(countOf(kV61RootRules) + countOf(kV61DayRules) <= ForecastSchema::kMaxRules,
+              "v61字段规则超过ForecastSchema::kMaxRules");
+
+} // namespace
+
+const ForecastSchema *ForecastSchema::find(const QString &version)
+{
+    for(const ForecastSchema &schema : kSchemas)
+    {
+        if(version == QLatin1String(schema.version))
+        {
+            return &schema;
+        }
+    }
+    return nullptr;
+}
+
+QString ForecastSchema::supportedVersions()
+{
+    QStringList versions;
+    for(const ForecastSchema &schema : kSchemas)
+    {
+        versions.append(QLatin1String(schema.version));
+    }
+    return versions.join(", ");
+}
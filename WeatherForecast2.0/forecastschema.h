@@ -0,0 +1,85 @@
+/**
+ * @file forecastschema.h
+ * @brief 天气API响应格式描述的头文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 该文件定义了天气数据的字段（ForecastField）和各API版本的响应格式（ForecastSchema）。
+ * 每个版本的格式是一张编译期确定的字段表，记录每个字段在响应中的路径，
+ * 由ForecastParser按表扫描；支持新的API版本只需增加一张表，不需要新的解析器。
+ */
+
+#ifndef FORECASTSCHEMA_H
+#define FORECASTSCHEMA_H
+
+#include <QString>      // Qt字符串类
+
+/**
+ * @brief 天气数据中的字段
+ *
+ * 城市名称和PM2.5属于整个响应，记录在第一天；其余字段每天一份。
+ */
+enum ForecastField
+{
+    FieldCity,              // 城市名称
+    FieldPm25,              // PM2.5
+    FieldDate,              // 日期，由LazyForecast::dayNumber转换为日序号；星期由日序号推算，不读取
+    FieldWeatherType,       // 天气类型
+    FieldTemp,              // 当前温度
+    FieldTempHigh,          // 最高温度
+    FieldTempLow,           // 最低温度
+    FieldWindDirection,     // 风向
+    FieldWindSpeed,         // 风力
+    FieldAirQuality,        // 空气质量等级
+    FieldTips,              // 感冒指数
+    FieldHumidity,          // 湿度
+    FieldCount
+};
+
+/**
+ * @brief 一个字段在响应中的路径
+ *
+ * 路径由'.'分隔，每一段是对象的键或数组的下标，
+ * 如"win.0"表示win数组的第一项，"index.3.desc"表示index数组第4项的desc。
+ */
+struct FieldRule
+{
+    ForecastField field;    // 字段
+    const char *path;       // 相对于所在对象的路径
+    bool required;          // 是否必需，缺少时整个响应视为无效
+};
+
+/**
+ * @brief 一个API版本的响应格式
+ *
+ * 多天预报的版本把每天的数据放在daysKey指向的数组中，dayRules相对于数组中的每一项；
+ * 只有当天实况的版本daysKey为nullptr，dayRules也相对于根对象，结果只有一天。
+ */
+struct ForecastSchema
+{
+    const char *version;            // API版本，与配置中的version相同
+    const char *daysKey;            // 每天数据所在数组的键，nullptr表示只有当天
+    const FieldRule *rootRules;     // 根对象中的字段，写入第一天
+    int rootRuleCount;
+    const FieldRule *dayRules;      // 每天的字段
+    int dayRuleCount;
+
+    /**
+     * @brief 每个版本最多的字段规则数，扫描时在栈上匹配
+     */
+    static const int kMaxRules = 16;
+
+    /**
+     * @brief 根据API版本查找响应格式
+     * @param version API版本，如"v9"
+     * @return 响应格式，不支持的版本返回nullptr
+     */
+    static const ForecastSchema *find(const QString &version);
+
+    /**
+     * @brief 支持的API版本，用于配置校验的错误信息
+     */
+    static QString supportedVersions();
+};
+
+#endif // FORECASTSCHEMA_H
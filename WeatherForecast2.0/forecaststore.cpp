@@ -0,0 +1,89 @@
+/**
+ * @file forecaststore.cpp
+ * @brief 天气数据快照仓库类的实现文件
+ * @author Weather Forecast Team
+ * @date 2025
+ */
+
+#include "forecaststore.h"    // 天气数据快照仓库类头文件
+
+#include <QMutexLocker>       // 自动加锁解锁
+
+ForecastStore::ForecastStore(QObject *parent)
+    : QObject(parent)
+    , mSerial(0)
+{
+    // 队列连接需要按名称复制信号参数
+    qRegisterMetaType<ForecastSnapshot>("ForecastSnapshot");
+    qRegisterMetaType<ForecastDiff>("ForecastDiff");
+}
+
+ForecastDiff ForecastStore::publish(const QString &cityCode, const ForecastSnapshot &forecast)
+{
+    if(!forecast)
+    {
+        return ForecastDiff();
+    }
+    if(cityCode.isEmpty())
+    {
+        return ForecastDiff::full();
+    }
+
+    // 被替换的旧快照在锁外释放，仍在使用它的持有者不受影响
+    ForecastSnapshot evicted;
+    ForecastSnapshot replaced;
+    ForecastDiff diff;
+    {
+        QMutexLocker locker(&mMutex);
+
+        // 已满时淘汰最早发布的一项
+        if(mEntries.size() >= kMaxEntries && !mEntries.contains(cityCode))
+        {
+            QHash<QString,Entry>::iterator oldest = mEntries.begin();
+            for(QHash<QString,Entry>::iterator it = mEntries.begin(); it != mEntries.end(); ++it)
+            {
+                if(it.value().serial < oldest.value().serial)
+                {
+                    oldest = it;
+                }
+            }
+            evicted = oldest.value().forecast;
+            mEntries.erase(oldest);
+        }
+
+        Entry &entry = mEntries[cityCode];
+        replaced = entry.forecast;
+        diff = ForecastDiff::compute(replaced.data(), *forecast);
+
+        // 内容没有变化时保留旧快照，持有者手中的快照仍是当前快照
+        if(!diff.isEmpty())
+        {
+            entry.forecast = forecast;
+        }
+        entry.serial = mSerial++;
+    }
+
+    // 数据没有变化的刷新不通知订阅者
+    if(!diff.isEmpty())
+    {
+        emit forecastChanged(cityCode, forecast, diff);
+    }
+    return diff;
+}
+
+ForecastSnapshot ForecastStore::snapshot(const QString &cityCode) const
+{
+    QMutexLocker locker(&mMutex);
+    QHash<QString,Entry>::const_iterator it = mEntries.constFind(cityCode);
+    return it == mEntries.constEnd() ? ForecastSnapshot() : it.value().forecast;
+}
+
+void ForecastStore::clear()
+{
+    // 旧快照在锁外释放
+    QHash<QString,Entry> old;
+    {
+        QMutexLocker locker(&mMutex);
+        old.swap(mEntries);
+    }
+}
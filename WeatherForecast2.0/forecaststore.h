@@ -0,0 +1,97 @@
+/**
+ * @file forecaststore.h
+ * @brief 天气数据快照仓库类的头文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 该文件定义了ForecastStore类，按城市代码保存当前的天气数据快照。
+ * 解析完成的快照以原子方式替换旧快照，界面、导出和提醒等使用者
+ * 在任意线程取得快照后即可不加锁地读取，替换不会影响已取得的旧快照。
+ * 每次发布时计算与该城市旧快照的字段级增量，有变化时通过forecastChanged
+ * 信号通知订阅者，数据没有变化的刷新不会通知任何人。
+ */
+
+#ifndef FORECASTSTORE_H
+#define FORECASTSTORE_H
+
+#include "forecastdiff.h"       // 字段级增量
+#include "forecastrecord.h"     // 天气数据快照
+
+#include <QObject>              // Qt对象基类
+#include <QHash>                // 城市代码到快照的映射
+#include <QMutex>               // 互斥锁，保护快照指针的替换
+#include <QString>              // Qt字符串类
+
+/**
+ * @class ForecastStore
+ * @brief 按城市代码保存的天气数据快照和变化通知
+ *
+ * 锁只保护映射表和快照指针的读写，持锁期间不解析也不复制天气数据，
+ * 只做一次逐字段比较，使同一城市的并发发布得到连续的增量；
+ * 快照本身不可变，取得后的读取不需要任何同步。
+ * 快照数量超过上限时淘汰最早发布的一项。
+ *
+ * forecastChanged在发布者的线程中发出，其他线程的订阅者使用队列连接接收。
+ */
+class ForecastStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 最多保存的城市数量，与原始数据缓存一致
+     */
+    static const int kMaxEntries = 32;
+
+    /**
+     * @brief 构造函数
+     * @param parent 父对象指针
+     */
+    explicit ForecastStore(QObject *parent = nullptr);
+
+    /**
+     * @brief 发布一个城市的新快照，替换旧快照
+     * @param cityCode 城市代码，为空（服务器默认城市）时只计算增量，不保存
+     * @param forecast 新的天气数据快照
+     * @return 与该城市旧快照的增量，没有旧快照时所有字段都标记为变化
+     */
+    ForecastDiff publish(const QString &cityCode, const ForecastSnapshot &forecast);
+
+    /**
+     * @brief 获取一个城市的当前快照
+     * @return 当前快照，没有该城市的数据时返回空指针，可在任意线程调用
+     */
+    ForecastSnapshot snapshot(const QString &cityCode) const;
+
+    /**
+     * @brief 清空全部快照，API版本切换后旧版本的数据不再发布
+     *
+     * 之后每个城市的第一次发布都是完整增量。
+     */
+    void clear();
+
+signals:
+    /**
+     * @brief 一个城市的快照有字段变化时发出
+     * @param cityCode 城市代码
+     * @param forecast 新的快照
+     * @param diff 与该城市旧快照的增量，不为空
+     */
+    void forecastChanged(const QString &cityCode, ForecastSnapshot forecast, ForecastDiff diff);
+
+private:
+    /**
+     * @brief 快照项
+     */
+    struct Entry
+    {
+        ForecastSnapshot forecast;  // 天气数据快照
+        quint64 serial;             // 发布序号，用于淘汰最早发布的一项
+    };
+
+    mutable QMutex mMutex;              // 保护mEntries和mSerial的读写
+    QHash<QString,Entry> mEntries;      // 城市代码到快照项的映射
+    quint64 mSerial;                    // 下一次发布的序号
+};
+
+#endif // FORECASTSTORE_H
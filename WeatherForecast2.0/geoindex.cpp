@@ -0,0 +1,255 @@
+/**
+ * @file geoindex.cpp
+ * @brief 城市坐标空间索引类的实现文件
+ * @author Weather Forecast Team
+ * @date 2025
+ */
+
+#include "geoindex.h"         // 城市坐标空间索引类头文件
+
+#include <QtMath>             // qSin、qCos、qAsin、qSqrt、qDegreesToRadians
+
+#include <algorithm>          // std::nth_element、std::push_heap、std::sort
+
+const double GeoIndex::kEarthRadiusKm = 6371.0088;
+
+/**
+ * @brief 将经纬度转换为单位球面上的三维坐标
+ */
+static void toUnitVector(double latitude, double longitude, float *out)
+{
+    double lat = qDegreesToRadians(latitude);
+    double lon = qDegreesToRadians(longitude);
+    out[0] = static_cast<float>(qCos(lat) * qCos(lon));
+    out[1] = static_cast<float>(qCos(lat) * qSin(lon));
+    out[2] = static_cast<float>(qSin(lat));
+}
+
+/**
+ * @brief 弦长平方转换为球面距离（千米）
+ */
+static double chord2ToKm(float chord2)
+{
+    double half = qSqrt(static_cast<double>(chord2)) / 2;
+    return 2 * GeoIndex::kEarthRadiusKm * qAsin(qMin(1.0, half));
+}
+
+/**
+ * @brief 三维坐标之间的距离平方（即弦长平方）
+ */
+static float distance2(const float *a, const float *b)
+{
+    float dx = a[0] - b[0];
+    float dy = a[1] - b[1];
+    float dz = a[2] - b[2];
+    return dx * dx + dy * dy + dz * dz;
+}
+
+void GeoIndex::build(const QVector<GeoPoint> &points)
+{
+    mNodes.clear();
+    mNodes.reserve(points.size());
+    for(const GeoPoint &point : points)
+    {
+        // 忽略缺失或超出范围的坐标
+        if(!(point.latitude >= -90 && point.latitude <= 90
+             && point.longitude >= -180 && point.longitude <= 180))
+        {
+            continue;
+        }
+        Node node;
+        toUnitVector(point.latitude, point.longitude, node.position);
+        node.axis = 0;
+        node.city = point.city;
+        mNodes.append(node);
+    }
+    buildRange(0, mNodes.size());
+}
+
+void GeoIndex::buildRange(int lo, int hi)
+{
+    if(hi - lo <= 1)
+    {
+        return;
+    }
+
+    // 选择坐标跨度最大的维度划分，城市分布不均匀时树更平衡
+    float minValue[3] = { 2, 2, 2 };
+    float maxValue[3] = { -2, -2, -2 };
+    for(int i = lo; i < hi; i++)
+    {
+        for(int d = 0; d < 3; d++)
+        {
+            minValue[d] = qMin(minValue[d], mNodes[i].position[d]);
+            maxValue[d] = qMax(maxValue[d], mNodes[i].position[d]);
+        }
+    }
+    quint8 axis = 0;
+    for(quint8 d = 1; d < 3; d++)
+    {
+        if(maxValue[d] - minValue[d] > maxValue[axis] - minValue[axis])
+        {
+            axis = d;
+        }
+    }
+
+    int mid = lo + (hi - lo) / 2;
+    Node *nodes = mNodes.data();
+    std::nth_element(nodes + lo, nodes + mid, nodes + hi, [axis](const Node &a, const Node &b) {
+        return a.position[axis] < b.position[axis];
+    });
+    nodes[mid].axis = axis;
+
+    buildRange(lo, mid);
+    buildRange(mid + 1, hi);
+}
+
+bool GeoIndex::isEmpty() const
+{
+    return mNodes.isEmpty();
+}
+
+/**
+ * @brief 按弦长平方比较，用于最大堆
+ */
+static bool closer(const QPair<float,quint32> &a, const QPair<float,quint32> &b)
+{
+    return a.first < b.first;
+}
+
+void GeoIndex::searchNearest(int lo, int hi, const float *target, int count,
+                             QVector<QPair<float,quint32>> *best) const
+{
+    if(lo >= hi)
+    {
+        return;
+    }
+    int mid = lo + (hi - lo) / 2;
+    const Node &node = mNodes[mid];
+
+    // 维护count个最近结果的最大堆，堆顶是其中最远的一个
+    float d2 = distance2(node.position, target);
+    if(best->size() < count)
+    {
+        best->append(qMakePair(d2, node.city));
+        std::push_heap(best->begin(), best->end(), closer);
+    }
+    else if(d2 < best->first().first)
+    {
+        std::pop_heap(best->begin(), best->end(), closer);
+        best->last() = qMakePair(d2, node.city);
+        std::push_heap(best->begin(), best->end(), closer);
+    }
+
+    // 先搜索查询点所在的一侧，另一侧只在划分平面比当前最远结果更近时才搜索
+    float delta = target[node.axis] - node.position[node.axis];
+    bool leftFirst = delta < 0;
+    if(leftFirst)
+    {
+        searchNearest(lo, mid, target, count, best);
+    }
+    else
+    {
+        searchNearest(mid + 1, hi, target, count, best);
+    }
+    if(best->size() < count || delta * delta < best->first().first)
+    {
+        if(leftFirst)
+        {
+            searchNearest(mid + 1, hi, target, count, best);
+        }
+        else
+        {
+            searchNearest(lo, mid, target, count, best);
+        }
+    }
+}
+
+void GeoIndex::searchRadius(int lo, int hi, const float *target, float maxChord2,
+                            QVector<QPair<float,quint32>> *result) const
+{
+    if(lo >= hi)
+    {
+        return;
+    }
+    int mid = lo + (hi - lo) / 2;
+    const Node &node = mNodes[mid];
+
+    float d2 = distance2(node.position, target);
+    if(d2 <= maxChord2)
+    {
+        result->append(qMakePair(d2, node.city));
+    }
+
+    // 划分平面在半径之外的一侧整体跳过
+    float delta = target[node.axis] - node.position[node.axis];
+    if(delta <= 0 || delta * delta <= maxChord2)
+    {
+        searchRadius(lo, mid, target, maxChord2, result);
+    }
+    if(delta >= 0 || delta * delta <= maxChord2)
+    {
+        searchRadius(mid + 1, hi, target, maxChord2, result);
+    }
+}
+
+/**
+ * @brief 将按弦长平方排序的结果转换为查询结果
+ */
+static QVector<GeoMatch> toMatches(QVector<QPair<float,quint32>> &found)
+{
+    std::sort(found.begin(), found.end(), closer);
+    QVector<GeoMatch> matches;
+    matches.reserve(found.size());
+    for(const QPair<float,quint32> &item : found)
+    {
+        GeoMatch match;
+        match.city = item.second;
+        match.distanceKm = chord2ToKm(item.first);
+        matches.append(match);
+    }
+    return matches;
+}
+
+QVector<GeoMatch> GeoIndex::nearest(double latitude, double longitude, int count) const
+{
+    QVector<QPair<float,quint32>> best;
+    if(count <= 0)
+    {
+        return QVector<GeoMatch>();
+    }
+    float target[3];
+    toUnitVector(latitude, longitude, target);
+    best.reserve(count);
+    searchNearest(0, mNodes.size(), target, count, &best);
+    return toMatches(best);
+}
+
+QVector<GeoMatch> GeoIndex::withinRadius(double latitude, double longitude, double radiusKm) const
+{
+    QVector<QPair<float,quint32>> found;
+    if(radiusKm < 0)
+    {
+        return QVector<GeoMatch>();
+    }
+    float target[3];
+    toUnitVector(latitude, longitude, target);
+
+    // 球面距离换算为弦长：chord = 2·sin(d / 2R)，超过半个地球周长时包含全部城市
+    double angle = qMin(radiusKm / kEarthRadiusKm, M_PI);
+    float chord = static_cast<float>(2 * qSin(angle / 2));
+    searchRadius(0, mNodes.size(), target, chord * chord, &found);
+    return toMatches(found);
+}
+
+double GeoIndex::distanceKm(double latitude1, double longitude1,
+                            double latitude2, double longitude2)
+{
+    // 半正矢公式，双精度计算，近距离时也保持精度
+    double lat1 = qDegreesToRadians(latitude1);
+    double lat2 = qDegreesToRadians(latitude2);
+    double sinLat = qSin((lat2 - lat1) / 2);
+    double sinLon = qSin(qDegreesToRadians(longitude2 - longitude1) / 2);
+    double h = sinLat * sinLat + qCos(lat1) * qCos(lat2) * sinLon * sinLon;
+    return 2 * kEarthRadiusKm * qAsin(qMin(1.0, qSqrt(h)));
+}
@@ -0,0 +1,126 @@
+/**
+ * @file geoindex.h
+ * @brief 城市坐标空间索引类的头文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 该文件定义了GeoIndex类，在城市经纬度上建立静态k-d树，
+ * 支持最近N个城市查询和半径范围查询，用于把传感器或GPS坐标映射到最近的预报城市。
+ */
+
+#ifndef GEOINDEX_H
+#define GEOINDEX_H
+
+#include <QPair>        // 查询过程中的（弦长平方，城市下标）对
+#include <QVector>      // 树节点数组
+#include <QtGlobal>     // quint32等基本类型
+
+/**
+ * @struct GeoPoint
+ * @brief 建立索引时输入的城市坐标
+ */
+struct GeoPoint
+{
+    double latitude;    // 纬度（度），北纬为正
+    double longitude;   // 经度（度），东经为正
+    quint32 city;       // 城市下标
+};
+
+/**
+ * @struct GeoMatch
+ * @brief 空间查询结果
+ */
+struct GeoMatch
+{
+    quint32 city;       // 城市下标
+    double distanceKm;  // 与查询点的球面距离（千米）
+};
+
+/**
+ * @class GeoIndex
+ * @brief 城市坐标的k-d树索引
+ *
+ * 经纬度先转换为单位球面上的三维坐标，弦长与球面距离单调对应，
+ * 因此在三维欧氏空间中建树即可得到正确的球面最近邻，
+ * 不需要特殊处理经度±180°和两极附近的情况。
+ *
+ * 树以隐式数组存储：区间[lo, hi)的根节点位于中点，左右子树分别为两侧的区间，
+ * 不需要任何指针。建立后只读，可以在多个线程中同时查询。
+ */
+class GeoIndex
+{
+public:
+    /**
+     * @brief 地球平均半径（千米）
+     */
+    static const double kEarthRadiusKm;
+
+    /**
+     * @brief 建立索引，替换原有内容
+     * @param points 城市坐标，超出有效范围的坐标会被忽略
+     */
+    void build(const QVector<GeoPoint> &points);
+
+    /**
+     * @brief 索引是否为空
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief 查询离给定坐标最近的若干个城市
+     * @param latitude 纬度（度）
+     * @param longitude 经度（度）
+     * @param count 最多返回的城市数量
+     * @return 按距离从近到远排列的结果
+     */
+    QVector<GeoMatch> nearest(double latitude, double longitude, int count) const;
+
+    /**
+     * @brief 查询给定半径内的全部城市
+     * @param latitude 纬度（度）
+     * @param longitude 经度（度）
+     * @param radiusKm 半径（千米）
+     * @return 按距离从近到远排列的结果
+     */
+    QVector<GeoMatch> withinRadius(double latitude, double longitude, double radiusKm) const;
+
+    /**
+     * @brief 计算两点之间的球面距离
+     * @return 距离（千米）
+     */
+    static double distanceKm(double latitude1, double longitude1,
+                             double latitude2, double longitude2);
+
+private:
+    /**
+     * @brief 树节点
+     */
+    struct Node
+    {
+        float position[3];  // 单位球面上的三维坐标
+        quint8 axis;        // 本节点的划分维度
+        quint32 city;       // 城市下标
+    };
+
+    /**
+     * @brief 递归建立区间[lo, hi)的子树
+     */
+    void buildRange(int lo, int hi);
+
+    /**
+     * @brief 最近邻查询的递归部分
+     * @param best 当前最近的结果，按弦长平方组成最大堆
+     */
+    void searchNearest(int lo, int hi, const float *target, int count,
+                       QVector<QPair<float,quint32>> *best) const;
+
+    /**
+     * @brief 半径查询的递归部分
+     */
+    void searchRadius(int lo, int hi, const float *target, float maxChord2,
+                      QVector<QPair<float,quint32>> *result) const;
+
+    QVector<Node> mNodes;   // 隐式k-d树
+};
+
+#endif // GEOINDEX_H
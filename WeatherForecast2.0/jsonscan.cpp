@@ -0,0 +1,135 @@
+/**
+ * @file jsonscan.cpp
+ * @brief JSON字节扫描工具类的实现文件
+ * @author Weather Forecast Team
+ * @date 2025
+ */
+
+#include "jsonscan.h"         // JSON字节扫描工具类头文件
+
+#include <cstring>            // memcmp
+
+const char *JsonScan::skipSpace(const char *p, const char *end)
+{
+    while(p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+    {
+        p++;
+    }
+    return p;
+}
+
+bool JsonScan::parseHex4(const char *p, const char *end, uint *value)
+{
+    if(end - p < 4)
+    {
+        return false;
+    }
+    uint result = 0;
+    for(int i = 0; i < 4; i++)
+    {
+        char c = p[i];
+        result <<= 4;
+        if(c >= '0' && c <= '9')
+        {
+            result |= static_cast<uint>(c - '0');
+        }
+        else if(c >= 'a' && c <= 'f')
+        {
+            result |= static_cast<uint>(c - 'a' + 10);
+        }
+        else if(c >= 'A' && c <= 'F')
+        {
+            result |= static_cast<uint>(c - 'A' + 10);
+        }
+        else
+        {
+            return false;
+        }
+    }
+    *value = result;
+    return true;
+}
+
+const char *JsonScan::skipString(const char *p, const char *end, bool *escaped)
+{
+    if(escaped)
+    {
+        *escaped = false;
+    }
+    p++;
+    while(p < end)
+    {
+        if(*p == '"')
+        {
+            return p + 1;
+        }
+        if(*p == '\\')
+        {
+            // 转义字符本身的合法性由解码时检查，这里只跳过被转义的字符
+            if(escaped)
+            {
+                *escaped = true;
+            }
+            p++;
+        }
+        p++;
+    }
+    return nullptr;
+}
+
+const char *JsonScan::skipValue(const char *p, const char *end)
+{
+    if(p >= end)
+    {
+        return nullptr;
+    }
+    if(*p == '"')
+    {
+        return skipString(p, end);
+    }
+    if(*p == '{' || *p == '[')
+    {
+        // 嵌套的对象和数组按括号深度整体跳过
+        int depth = 0;
+        while(p < end)
+        {
+            if(*p == '"')
+            {
+                p = skipString(p, end);
+                if(!p)
+                {
+                    return nullptr;
+                }
+                continue;
+            }
+            if(*p == '{' || *p == '[')
+            {
+                depth++;
+            }
+            else if(*p == '}' || *p == ']')
+            {
+                depth--;
+                if(depth == 0)
+                {
+                    return p + 1;
+                }
+            }
+            p++;
+        }
+        return nullptr;
+    }
+
+    // 数字、true、false、null
+    const char *start = p;
+    while(p < end && *p != ',' && *p != '}' && *p != ']'
+          && *p != ' ' && *p != '\n' && *p != '\r' && *p != '\t')
+    {
+        p++;
+    }
+    return p > start ? p : nullptr;
+}
+
+bool JsonScan::keyEquals(const char *begin, const char *end, const char *name, int length)
+{
+    return end - begin == length && memcmp(begin, name, static_cast<size_t>(length)) == 0;
+}
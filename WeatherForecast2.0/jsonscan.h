@@ -0,0 +1,62 @@
+/**
+ * @file jsonscan.h
+ * @brief JSON字节扫描工具类的头文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 该文件定义了JsonScan类，提供直接在原始字节上扫描JSON的基本操作，
+ * 供城市数据读取（CityDataReader）和天气响应解析（ForecastParser）共用。
+ * 这些函数不分配内存，也不构造QJsonDocument。
+ */
+
+#ifndef JSONSCAN_H
+#define JSONSCAN_H
+
+#include <QtGlobal>     // uint等基本类型
+
+/**
+ * @class JsonScan
+ * @brief JSON字节扫描工具
+ *
+ * 所有函数的p参数指向当前位置，end指向数据结尾，不要求数据以'\0'结尾；
+ * 返回值为扫描结束后的位置，格式错误时返回nullptr。
+ */
+class JsonScan
+{
+public:
+    /**
+     * @brief 跳过空白字符
+     */
+    static const char *skipSpace(const char *p, const char *end);
+
+    /**
+     * @brief 读取4位十六进制数
+     * @return 是否成功
+     */
+    static bool parseHex4(const char *p, const char *end, uint *value);
+
+    /**
+     * @brief 跳过一个JSON字符串
+     * @param p 指向开头的引号
+     * @param escaped 不为nullptr时写入字符串中是否含有转义字符
+     * @return 结尾引号之后的位置
+     */
+    static const char *skipString(const char *p, const char *end, bool *escaped = nullptr);
+
+    /**
+     * @brief 跳过一个任意类型的JSON值
+     * @return 值之后的位置
+     */
+    static const char *skipValue(const char *p, const char *end);
+
+    /**
+     * @brief 判断JSON字符串的原始内容是否等于给定的ASCII字符串
+     * @param begin 字符串内容的开头（开头引号之后）
+     * @param end 字符串内容的结尾（结尾引号的位置）
+     * @param name 比较的字符串
+     * @param length 比较的字符串的长度
+     */
+    static bool keyEquals(const char *begin, const char *end, const char *name, int length);
+};
+
+#endif // JSONSCAN_H
@@ -0,0 +1,188 @@
+/**
+ * @file lazyforecast.cpp
+ * @brief 按需解码的天气数据类的实现文件
+ * @author Weather Forecast Team
+ * @date 2025
+ */
+
+#include "lazyforecast.h"     // 按需解码的天气数据类头文件
+#include "recordpool.h"       // 按线程缓存的对象内存
+
+LazyForecast::LazyForecast()
+{
+    for(int day = 0; day < ForecastIndex::kMaxDays; day++)
+    {
+        mDecoded[day] = 0;
+        mWeatherTypes[day] = -1;
+        mAirQualities[day] = -1;
+        mDayNumbers[day] = ForecastDate::kInvalidDay;
+        mDayNumbersResolved[day] = false;
+    }
+}
+
+LazyForecast::LazyForecast(const QByteArray &rawData)
+    : LazyForecast()
+{
+    mRawData = rawData;
+}
+
+void *LazyForecast::operator new(size_t size)
+{
+    return RecordPool<LazyForecast>::allocate(size);
+}
+
+void LazyForecast::operator delete(void *block, size_t size)
+{
+    RecordPool<LazyForecast>::release(block, size);
+}
+
+QSharedPointer<LazyForecast> LazyForecast::fromReply(const QByteArray &rawData, const ForecastSchema &schema,
+                                                     ForecastError *error, QString *serverMessage)
+{
+    QSharedPointer<LazyForecast> forecast(new LazyForecast(rawData));
+    ForecastError result = ForecastParser::scan(forecast->mRawData, schema, &forecast->mIndex);
+    if(error)
+    {
+        *error = result;
+    }
+    if(result == ForecastOk)
+    {
+        return forecast;
+    }
+
+    // 错误信息只在出错时解码，解码到对象自己的内存池后随对象释放
+    if(serverMessage && result == ForecastApiError)
+    {
+        *serverMessage = ForecastParser::decode(forecast->mRawData, forecast->mIndex.errorMessage,
+                                                &forecast->mArena).toString();
+    }
+    return QSharedPointer<LazyForecast>();
+}
+
+int LazyForecast::dayCount() const
+{
+    return mIndex.dayCount;
+}
+
+bool LazyForecast::contains(int day, ForecastField field) const
+{
+    // 城市名称和PM2.5不依赖data数组，其余字段只在响应的天数内有值
+    if(day < 0 || day >= ForecastIndex::kMaxDays)
+    {
+        return false;
+    }
+    return (field == FieldCity || field == FieldPm25) ? day == 0 : day < mIndex.dayCount;
+}
+
+QStringView LazyForecast::text(int day, ForecastField field) const
+{
+    if(!contains(day, field))
+    {
+        return QStringView();
+    }
+    quint16 bit = static_cast<quint16>(1u << field);
+    if(!(mDecoded[day] & bit))
+    {
+        mTexts[day][field] = ForecastParser::decode(mRawData, mIndex.fields[day][field], &mArena);
+        mDecoded[day] |= bit;
+    }
+    return mTexts[day][field];
+}
+
+QString LazyForecast::string(int day, ForecastField field) const
+{
+    return text(day, field).toString();
+}
+
+int LazyForecast::temperature(int day, ForecastField field) const
+{
+    // 温度文字只有几个字符，解码结果已缓存，这里不再单独缓存整数值
+    return ForecastParser::toInt(text(day, field));
+}
+
+qint32 LazyForecast::dayNumber(int day) const
+{
+    if(!contains(day, FieldDate))
+    {
+        return ForecastDate::kInvalidDay;
+    }
+    if(!mDayNumbersResolved[day])
+    {
+        const FieldSpan &span = mIndex.fields[day][FieldDate];
+        QVarLengthArray<char, 64> utf8;
+        ForecastParser::utf8(mRawData, span, span.escaped ? text(day, FieldDate) : QStringView(), &utf8);
+        mDayNumbers[day] = ForecastDate::fromUtf8(utf8.constData(), utf8.size());
+        mDayNumbersResolved[day] = true;
+    }
+    return mDayNumbers[day];
+}
+
+WeatherTypeId LazyForecast::weatherType(int day) const
+{
+    if(!contains(day, FieldWeatherType))
+    {
+        return WeatherTables::kUnknownWeatherType;
+    }
+    if(mWeatherTypes[day] < 0)
+    {
+        const FieldSpan &span = mIndex.fields[day][FieldWeatherType];
+        QVarLengthArray<char, 64> utf8;
+        ForecastParser::utf8(mRawData, span, span.escaped ? text(day, FieldWeatherType) : QStringView(), &utf8);
+        mWeatherTypes[day] = WeatherTables::weatherTypeFromUtf8(utf8.constData(), utf8.size());
+    }
+    return static_cast<WeatherTypeId>(mWeatherTypes[day]);
+}
+
+AirQualityId LazyForecast::airQuality(int day) const
+{
+    if(!contains(day, FieldAirQuality))
+    {
+        return WeatherTables::kUnknownAirQuality;
+    }
+    if(mAirQualities[day] < 0)
+    {
+        const FieldSpan &span = mIndex.fields[day][FieldAirQuality];
+        QVarLengthArray<char, 64> utf8;
+        ForecastParser::utf8(mRawData, span, span.escaped ? text(day, FieldAirQuality) : QStringView(), &utf8);
+        mAirQualities[day] = WeatherTables::airQualityFromUtf8(utf8.constData(), utf8.size());
+    }
+    return static_cast<AirQualityId>(mAirQualities[day]);
+}
+
+Day LazyForecast::day(int index) const
+{
+    Day result;
+    result.mCity = text(index, FieldCity);
+    result.mPm25 = text(index, FieldPm25);
+    result.mDayNumber = dayNumber(index);
+    result.mWeathType = text(index, FieldWeatherType);
+    result.mWeatherTypeId = weatherType(index);
+    result.mTemp = text(index, FieldTemp);
+    result.mTempHigh = text(index, FieldTempHigh);
+    result.mTempHighValue = temperature(index, FieldTempHigh);
+    result.mTempLow = text(index, FieldTempLow);
+    result.mTempLowValue = temperature(index, FieldTempLow);
+    result.mFx = text(index, FieldWindDirection);
+    result.mFl = text(index, FieldWindSpeed);
+    result.mAirq = text(index, FieldAirQuality);
+    result.mAirqId = airQuality(index);
+    result.mTips = text(index, FieldTips);
+    result.mHu = text(index, FieldHumidity);
+    return result;
+}
+
+int LazyForecast::decodedCount() const
+{
+    int count = 0;
+    for(int day = 0; day < ForecastIndex::kMaxDays; day++)
+    {
+        for(int field = 0; field < FieldCount; field++)
+        {
+            if(mDecoded[day] & (1u << field))
+            {
+                count++;
+            }
+        }
+    }
+    return count;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file lazyforecast.h
+ * @brief 按需解码的天气数据类的头文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 该文件定义了LazyForecast类。它保留天气API返回的原始数据和一遍扫描得到的
+ * 字段位置索引，每个字段在首次访问时才解码并记住结果。
+ * 只需要少数字段的使用者（如校验响应、查询单个字段）不必解码全部字段；
+ * 需要在多个使用者之间共享时由ForecastRecord一次性取出全部字段。
+ */
+
+#ifndef LAZYFORECAST_H
+#define LAZYFORECAST_H
+
+#include "day.h"                // 单日天气数据
+#include "forecastparser.h"     // 结构扫描和字段解码
+#include "parsearena.h"         // 解码后文字所在的内存池
+
+#include <QByteArray>           // 保留的原始响应数据
+#include <QSharedPointer>       // 共享所有权
+
+/**
+ * @class LazyForecast
+ * @brief 按需解码的天气数据
+ *
+ * 通过fromReply创建，创建时只做结构扫描；之后的访问函数在首次使用某个字段时
+ * 才解码，解码后的文字位于对象自己的内存池中，与对象的生命周期相同。
+ *
+ * 访问函数虽然是const，但会写入解码缓存，不能在多个线程中同时访问同一个对象；
+ * 跨线程共享请使用ForecastRecord快照。
+ */
+class LazyForecast
+{
+public:
+    /**
+     * @brief 创建没有任何数据的天气数据，所有字段都是空文字
+     */
+    LazyForecast();
+
+    /**
+     * @brief 从RecordPool分配和释放，批量刷新时复用已释放对象的内存
+     */
+    static void *operator new(size_t size);
+    static void operator delete(void *block, size_t size);
+
+    /**
+     * @brief 扫描一次天气响应
+     * @param rawData 天气API返回的原始数据，隐式共享，不会复制
+     * @param schema 请求时使用的API版本的响应格式
+     * @param error 不为nullptr时写入扫描结果
+     * @param serverMessage 不为nullptr且服务器返回错误对象时写入其中的errmsg
+     * @return 天气数据，扫描失败时返回空指针
+     */
+    static QSharedPointer<LazyForecast> fromReply(const QByteArray &rawData, const ForecastSchema &schema,
+                                                  ForecastError *error = nullptr, QString *serverMessage = nullptr);
+
+    /**
+     * @brief 响应中的天数，最多ForecastIndex::kMaxDays天
+     *
+     * 只有当天实况的API版本为1，其余天的字段都是空文字。
+     */
+    int dayCount() const;
+
+    /**
+     * @brief 获取一个字段的文字，首次访问时解码
+     * @param day 第几天，超出响应天数时返回空文字
+     * @param field 字段；FieldCity和FieldPm25只在第一天有值
+     * @return 指向内存池的视图，在本对象释放前有效
+     */
+    QStringView text(int day, ForecastField field) const;
+
+    /**
+     * @brief 获取一个字段的文字并转换为QString，供界面直接使用
+     */
+    QString string(int day, ForecastField field) const;
+
+    /**
+     * @brief 获取温度字段的整数值
+     * @param field FieldTemp、FieldTempHigh或FieldTempLow
+     * @return 整数值，文字不是整数时为0
+     */
+    int temperature(int day, ForecastField field) const;
+
+    /**
+     * @brief 获取日期的日序号
+     * @return 日序号，没有日期或格式错误时返回ForecastDate::kInvalidDay
+     *
+     * 日期没有转义字符时直接由原始字节转换，不需要先解码文字。
+     */
+    qint32 dayNumber(int day) const;
+
+    /**
+     * @brief 获取天气类型ID
+     *
+     * 天气类型没有转义字符时直接用原始UTF-8查表，不需要先解码文字。
+     */
+    WeatherTypeId weatherType(int day) const;
+
+    /**
+     * @brief 获取空气质量等级ID
+     */
+    AirQualityId airQuality(int day) const;
+
+    /**
+     * @brief 解码一天的全部字段
+     * @return 单日天气数据，文字指向本对象的内存池
+     */
+    Day day(int index) const;
+
+    /**
+     * @brief 已解码的字段数，用于调试统计
+     */
+    int decodedCount() const;
+
+private:
+    explicit LazyForecast(const QByteArray &rawData);
+
+    /**
+     * @brief 字段是否在响应范围内
+     */
+    bool contains(int day, ForecastField field) const;
+
+    QByteArray mRawData;        // 原始响应数据
+    ForecastIndex mIndex;       // 字段位置索引
+
+    // 解码缓存：mDecoded的第field位表示该天的字段已解码
+    mutable ParseArena mArena;
+    mutable QStringView mTexts[ForecastIndex::kMaxDays][FieldCount];
+    mutable quint16 mDecoded[ForecastIndex::kMaxDays];
+
+    // 天气类型和空气质量ID的缓存，未查表时为-1
+    mutable int mWeatherTypes[ForecastIndex::kMaxDays];
+    mutable int mAirQualities[ForecastIndex::kMaxDays];
+
+    // 日序号的缓存
+    mutable qint32 mDayNumbers[ForecastIndex::kMaxDays];
+    mutable bool mDayNumbersResolved[ForecastIndex::kMaxDays];
+};
+
+#endif // LAZYFORECAST_H
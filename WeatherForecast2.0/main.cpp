@@ -9,8 +9,12 @@
  */
 
 #include "widget.h"     // 引入主窗口类定义
+#include "assetpack.h"  // 引入外部资源包加载类
+#include "singleinstance.h" // 引入单实例运行守护类
+#include "startupoptions.h" // 引入启动参数解析类
 
 #include <QApplication>  // 引入Qt应用程序类
+#include <cstdio>        // 输出帮助和错误信息
 
 /**
  * @brief 程序主入口函数
@@ -19,10 +23,11 @@
  * @return 程序退出状态码
  * 
  * 该函数是整个天气预报应用程序的启动入口点，负责：
- * 1. 初始化Qt应用程序环境
- * 2. 创建主窗口实例
- * 3. 显示主窗口界面
- * 4. 启动Qt事件循环，等待用户交互
+ * 1. 初始化Qt应用程序环境，解析启动参数
+ * 2. 检查是否已有实例在运行，有则转发参数后退出
+ * 3. 创建主窗口实例
+ * 4. 显示主窗口界面
+ * 5. 启动Qt事件循环，等待用户交互
  */
 int main(int argc, char *argv[])
 {
@@ -30,9 +35,51 @@ int main(int argc, char *argv[])
     // 处理命令行参数，设置应用程序的基本属性
     QApplication a(argc, argv);
     
+    // 解析启动参数（--city、--code、--offline、--no-fetch及URL协议）
+    StartupOptions options;
+    QString errorMessage;
+    if(!StartupOptions::parse(a.arguments(), &options, &errorMessage))
+    {
+        fprintf(stderr, "%s\n", qPrintable(errorMessage));
+        return 1;
+    }
+    if(options.helpRequested)
+    {
+        fprintf(stdout, "%s", qPrintable(StartupOptions::helpText()));
+        return 0;
+    }
+    
+    // 单实例检查：已有实例在运行时，把命令行参数转发给它并立即退出，
+    // 避免重复加载城市数据、图标和网络连接
+    SingleInstance instance("WeatherForecast");
+    if(instance.sendToRunningInstance(a.arguments()))
+    {
+        return 0;
+    }
+    // 两个进程同时启动时，后开始监听的一方把参数转发给先开始监听的一方后退出
+    if(!instance.listen() && instance.sendToRunningInstance(a.arguments()))
+    {
+        return 0;
+    }
+    
+    // 使用外部资源包构建时，在创建窗口之前挂载资源包
+    // 资源包只做内存映射，图标和城市数据在首次使用时才按页载入
+    // assetPack必须在窗口之前创建，保证窗口销毁前资源一直可用
+    AssetPack assetPack;
+#ifdef WEATHER_EXTERNAL_ASSETS
+    if(!assetPack.mount(AssetPack::defaultPath()))
+    {
+        qWarning("资源包加载失败，图标和城市数据将不可用");
+    }
+#endif
+    
     // 创建主窗口Widget实例
     // Widget类继承自QWidget，是应用程序的主界面容器
-    Widget w;
+    Widget w(options);
+    
+    // 接收后续启动转发过来的参数，由已运行的窗口处理
+    QObject::connect(&instance, &SingleInstance::messageReceived,
+                     &w, &Widget::handleInstanceMessage);
     
     // 显示主窗口
     // 调用show()方法使窗口可见，用户可以看到应用程序界面
@@ -0,0 +1,89 @@
+/**
+ * @file parsearena.cpp
+ * @brief 解析内存池类的实现文件
+ * @author Weather Forecast Team
+ * @date 2025
+ */
+
+#include "parsearena.h"       // 解析内存池类头文件
+
+#include <cstdlib>            // malloc、free
+
+ParseArena::ParseArena()
+    : mCurrent(mInline)
+    , mEnd(mInline + kInlineSize)
+    , mAllocated(0)
+{
+}
+
+ParseArena::~ParseArena()
+{
+    reset();
+}
+
+void *ParseArena::allocate(int size, int alignment)
+{
+    // 将当前位置向上对齐，剩余空间足够时直接移动指针
+    quintptr address = reinterpret_cast<quintptr>(mCurrent);
+    quintptr aligned = (address + static_cast<quintptr>(alignment - 1)) & ~static_cast<quintptr>(alignment - 1);
+    char *block = reinterpret_cast<char *>(aligned);
+    if(size <= mEnd - block)
+    {
+        mCurrent = block + size;
+        mAllocated += size;
+        return block;
+    }
+    return allocateSlow(size, alignment);
+}
+
+void *ParseArena::allocateSlow(int size, int alignment)
+{
+    // 超过半个内存块的请求单独分配，不浪费当前内存块的剩余空间
+    int blockSize = size + alignment > kBlockSize / 2 ? size + alignment : kBlockSize;
+    char *memory = static_cast<char *>(malloc(static_cast<size_t>(blockSize)));
+    Q_CHECK_PTR(memory);
+    mBlocks.append(memory);
+
+    quintptr aligned = (reinterpret_cast<quintptr>(memory) + static_cast<quintptr>(alignment - 1))
+            & ~static_cast<quintptr>(alignment - 1);
+    char *block = reinterpret_cast<char *>(aligned);
+    if(blockSize == kBlockSize)
+    {
+        mCurrent = block + size;
+        mEnd = memory + blockSize;
+    }
+    mAllocated += size;
+    return block;
+}
+
+QChar *ParseArena::allocateChars(int count)
+{
+    return static_cast<QChar *>(allocate(count * static_cast<int>(sizeof(QChar)), alignof(QChar)));
+}
+
+void ParseArena::shrinkLast(void *block, int oldSize, int newSize)
+{
+    char *start = static_cast<char *>(block);
+    if(start + oldSize == mCurrent && newSize <= oldSize)
+    {
+        mCurrent = start + newSize;
+        mAllocated -= oldSize - newSize;
+    }
+}
+
+void ParseArena::reset()
+{
+    for(char *memory : mBlocks)
+    {
+        free(memory);
+    }
+    mBlocks.clear();
+    mCurrent = mInline;
+    mEnd = mInline + kInlineSize;
+    mAllocated = 0;
+}
+
+qint64 ParseArena::bytesAllocated() const
+{
+    return mAllocated;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file parsearena.h
+ * @brief 解析内存池类的头文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 该文件定义了ParseArena类，一次天气响应解析过程中的全部文字都从同一个
+ * 内存池中顺序分配，不单独释放，整个内存池在天气数据被替换时一次性释放。
+ */
+
+#ifndef PARSEARENA_H
+#define PARSEARENA_H
+
+#include <QChar>            // UTF-16字符
+#include <QVarLengthArray>  // 追加的内存块列表
+
+/**
+ * @class ParseArena
+ * @brief 顺序分配的内存池
+ *
+ * 主要特点：
+ * - 分配只移动一个指针，没有锁，也不产生内存碎片
+ * - 自带kInlineSize字节的内联空间，一次普通响应的全部文字都能放下，
+ *   与内存池对象一起分配，解析过程不再调用malloc
+ * - 内联空间不足时追加kBlockSize字节的内存块，超大的请求单独分配
+ * - 只能整体释放，分配出的内存不会被移动，引用在内存池存在期间一直有效
+ */
+class ParseArena
+{
+public:
+    /**
+     * @brief 内联空间的字节数
+     */
+    static const int kInlineSize = 4096;
+
+    /**
+     * @brief 追加内存块的字节数
+     */
+    static const int kBlockSize = 16384;
+
+    /**
+     * @brief 构造函数，创建只使用内联空间的空内存池
+     */
+    ParseArena();
+
+    /**
+     * @brief 析构函数，释放全部追加的内存块
+     */
+    ~ParseArena();
+
+    /**
+     * @brief 分配内存
+     * @param size 字节数
+     * @param alignment 对齐字节数，必须是2的幂
+     * @return 分配的内存，内存池释放前一直有效
+     */
+    void *allocate(int size, int alignment = sizeof(void *));
+
+    /**
+     * @brief 分配UTF-16字符
+     * @param count 字符数
+     */
+    QChar *allocateChars(int count);
+
+    /**
+     * @brief 缩小最近一次分配的内存，归还结尾未使用的部分
+     * @param block 最近一次分配的内存
+     * @param oldSize 分配时的字节数
+     * @param newSize 实际使用的字节数
+     *
+     * 用于先按上限分配、写入后才知道实际长度的场景，如解码JSON字符串。
+     * block不是最近一次分配的内存时不做任何事情。
+     */
+    void shrinkLast(void *block, int oldSize, int newSize);
+
+    /**
+     * @brief 释放全部分配，保留内联空间以便重复使用
+     */
+    void reset();
+
+    /**
+     * @brief 已分配的字节数，用于统计
+     */
+    qint64 bytesAllocated() const;
+
+private:
+    Q_DISABLE_COPY(ParseArena)
+
+    /**
+     * @brief 当前内存块空间不足时追加新的内存块
+     */
+    void *allocateSlow(int size, int alignment);
+
+    char *mCurrent;                         // 当前内存块中下一次分配的位置
+    char *mEnd;                             // 当前内存块的结尾
+    qint64 mAllocated;                      // 已分配的字节数
+    QVarLengthArray<char *, 4> mBlocks;     // 追加的内存块
+    alignas(8) char mInline[kInlineSize];   // 内联空间
+};
+
+#endif // PARSEARENA_H
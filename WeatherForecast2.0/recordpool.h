@@ -0,0 +1,281 @@
+/**
+ * @file recordpool.h
+ * @brief 天气数据对象池的头文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 该文件定义了RecordPool类模板，为LazyForecast和ForecastRecord等固定大小的
+ * 天气数据对象提供按线程缓存的内存块。批量刷新所有城市时每轮都会创建和释放
+ * 大量这类对象（LazyForecast自带4KB的内联内存池），稳定运行后
+ * 释放的内存块直接被下一次创建复用，不再调用malloc和free。
+ * tools/poolbench比较了使用和不使用对象池时单线程和多线程的分配性能。
+ */
+
+#ifndef RECORDPOOL_H
+#define RECORDPOOL_H
+
+#include <QAtomicInt>       // 线程退出后仍在使用的内存块计数
+#include <QAtomicPointer>   // 其他线程归还的内存块链表
+#include <QtGlobal>         // Q_UNLIKELY等基本宏
+
+#include <cstddef>          // std::max_align_t
+#include <new>              // 全局operator new和operator delete
+
+/**
+ * @class RecordPool
+ * @brief 按线程缓存的固定大小内存块池
+ * @tparam T 对象类型，每种类型有自己的空闲链表
+ *
+ * 主要特点：
+ * - 每个内存块记录分配它的线程（所有者），无论在哪个线程释放都回到所有者的空闲链表，
+ *   后台线程创建、界面线程释放的流水线中，后台线程也能复用内存块
+ * - 在所有者线程中分配和释放不加锁，也没有原子操作
+ * - 其他线程释放的内存块以无锁方式压入所有者的归还链表，所有者的空闲链表
+ *   用完时一次取走整个归还链表
+ * - 每个线程最多缓存kMaxFreeBlocks块，超出的内存块直接交还系统
+ * - 线程退出时释放其空闲链表和归还链表中的全部内存块；仍在使用的内存块之后
+ *   由释放它的线程直接交还系统，最后一块交还时销毁所有者的记录
+ *
+ * 每个内存块前有一个头部，记录所有者和空闲时的链表指针，占用一个最大对齐单位。
+ * 由T的类专用operator new和operator delete调用；
+ * 只处理大小恰好为sizeof(T)的请求，其余交给全局operator new。
+ */
+template<class T>
+class RecordPool
+{
+public:
+    /**
+     * @brief 每个线程最多缓存的空闲内存块数
+     */
+    static const int kMaxFreeBlocks = 64;
+
+    /**
+     * @brief 分配一个对象的内存
+     * @param size 请求的字节数
+     */
+    static void *allocate(size_t size)
+    {
+        if(size != sizeof(T))
+        {
+            return ::operator new(size);
+        }
+
+        // 线程退出过程中所有者记录已经关闭，此时分配的内存块不属于任何线程
+        Owner *owner = Q_LIKELY(!sDestroyed) ? localOwner().owner : nullptr;
+        Block *block = nullptr;
+        if(owner)
+        {
+            if(!owner->head)
+            {
+                owner->drainReturned();
+            }
+            if(owner->head)
+            {
+                block = owner->head;
+                owner->head = block->next;
+                owner->count--;
+            }
+            owner->live++;
+        }
+        if(!block)
+        {
+            block = static_cast<Block *>(::operator new(sizeof(Block) + size));
+            block->owner = owner;
+        }
+        return block + 1;
+    }
+
+    /**
+     * @brief 释放一个对象的内存
+     * @param pointer allocate返回的内存
+     * @param size 对象的字节数
+     */
+    static void release(void *pointer, size_t size)
+    {
+        if(!pointer)
+        {
+            return;
+        }
+        if(size != sizeof(T))
+        {
+            ::operator delete(pointer);
+            return;
+        }
+
+        Block *block = static_cast<Block *>(pointer) - 1;
+        Owner *owner = block->owner;
+        if(!owner)
+        {
+            ::operator delete(block);
+            return;
+        }
+
+        // 所有者线程自己释放时直接放回空闲链表，其他线程释放时压入所有者的归还链表
+        if(Q_LIKELY(!sDestroyed) && owner == localOwner().owner)
+        {
+            owner->live--;
+            owner->push(block);
+            return;
+        }
+        owner->giveBack(block);
+    }
+
+    /**
+     * @brief 当前线程缓存的空闲内存块数，不含尚未取走的归还链表，用于调试统计
+     */
+    static int freeCount()
+    {
+        return sDestroyed ? 0 : localOwner().owner->count;
+    }
+
+private:
+    struct Owner;
+
+    /**
+     * @brief 内存块头部，对象紧随其后，保持最大对齐
+     */
+    struct alignas(std::max_align_t) Block
+    {
+        Owner *owner;   // 分配该内存块的线程，线程退出过程中分配的为nullptr
+        Block *next;    // 空闲时的链表指针
+    };
+
+    /**
+     * @brief 一个线程的内存块记录
+     *
+     * head、count和live只由所有者线程访问；returned和orphans由任意线程访问。
+     */
+    struct Owner
+    {
+        Block *head;                    // 空闲链表头
+        int count;                      // 空闲链表长度
+        int live;                       // 从本线程分配、尚未回到本线程的内存块数
+        QAtomicPointer<Block> returned; // 其他线程归还的内存块，线程退出后为closedMarker()
+        QAtomicInt orphans;             // 线程退出后仍在使用的内存块数，归零时销毁本记录
+
+        Owner() : head(nullptr), count(0), live(0), returned(nullptr), orphans(0) {}
+
+        /**
+         * @brief 放回空闲链表，已满时交还系统（所有者线程）
+         */
+        void push(Block *block)
+        {
+            if(count >= kMaxFreeBlocks)
+            {
+                ::operator delete(block);
+                return;
+            }
+            block->next = head;
+            head = block;
+            count++;
+        }
+
+        /**
+         * @brief 取走其他线程归还的全部内存块，放回空闲链表（所有者线程）
+         *
+         * 只有所有者一次性取走整个链表，其他线程只压入，因此不存在ABA问题。
+         */
+        void drainReturned()
+        {
+            if(!returned.loadAcquire())
+            {
+                return;
+            }
+            Block *block = returned.fetchAndStoreAcquire(nullptr);
+            while(block)
+            {
+                Block *next = block->next;
+                live--;
+                push(block);
+                block = next;
+            }
+        }
+
+        /**
+         * @brief 其他线程归还一个内存块
+         *
+         * 所有者已退出时直接交还系统；最后一个仍在使用的内存块交还后销毁本记录。
+         */
+        void giveBack(Block *block)
+        {
+            Block *first = returned.loadAcquire();
+            do
+            {
+                if(first == closedMarker())
+                {
+                    ::operator delete(block);
+                    if(!orphans.deref())
+                    {
+                        delete this;
+                    }
+                    return;
+                }
+                block->next = first;
+            }
+            while(!returned.testAndSetOrdered(first, block, first));
+        }
+    };
+
+    /**
+     * @brief 当前线程的所有者记录，线程退出时关闭
+     */
+    struct LocalOwner
+    {
+        Owner *owner;
+
+        LocalOwner() : owner(new Owner) {}
+
+        ~LocalOwner()
+        {
+            sDestroyed = true;
+
+            // 关闭归还链表，之后归还的内存块由归还的线程直接交还系统
+            Block *block = owner->returned.fetchAndStoreAcquire(closedMarker());
+            while(block)
+            {
+                Block *next = block->next;
+                owner->live--;
+                ::operator delete(block);
+                block = next;
+            }
+            while(owner->head)
+            {
+                Block *next = owner->head->next;
+                ::operator delete(owner->head);
+                owner->head = next;
+            }
+            owner->count = 0;
+
+            // 其他线程可能已经先交还了一部分，计数暂时为负；加上仍在使用的块数后归零表示全部交还
+            int live = owner->live;
+            if(owner->orphans.fetchAndAddOrdered(live) + live == 0)
+            {
+                delete owner;
+            }
+            owner = nullptr;
+        }
+    };
+
+    static LocalOwner &localOwner()
+    {
+        static thread_local LocalOwner local;
+        return local;
+    }
+
+    /**
+     * @brief 所有者线程已退出的标记，写入归还链表
+     */
+    static Block *closedMarker()
+    {
+        static Block marker;
+        return &marker;
+    }
+
+    // 当前线程的所有者记录是否已在线程退出时关闭；没有析构函数，关闭后仍可读取
+    static thread_local bool sDestroyed;
+};
+
+template<class T>
+thread_local bool RecordPool<T>::sDestroyed = false;
+
+#endif // RECORDPOOL_H
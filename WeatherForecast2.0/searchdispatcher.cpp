@@ -0,0 +1,91 @@
+/**
+ * @file searchdispatcher.cpp
+ * @brief 搜索框输入分发类的实现文件
+ * @author Weather Forecast Team
+ * @date 2025
+ */
+
+#include "searchdispatcher.h" // 搜索框输入分发类头文件
+
+#include <QInputMethodEvent>  // 输入法组字事件
+#include <QLineEdit>          // 搜索输入框
+#include <QTimer>             // 防抖定时器
+
+SearchDispatcher::SearchDispatcher(QLineEdit *lineEdit, QObject *parent)
+    : QObject(parent)
+    , mLineEdit(lineEdit)
+    , mDebounceTimer(new QTimer(this))
+    , mGeneration(0)
+    , mComposing(false)
+{
+    mDebounceTimer->setSingleShot(true);
+    mDebounceTimer->setInterval(kDebounceMs);
+    connect(mDebounceTimer, &QTimer::timeout, this, &SearchDispatcher::dispatch);
+
+    // textEdited只在用户修改时发出，程序调用setText不会触发查询
+    connect(mLineEdit, &QLineEdit::textEdited, this, &SearchDispatcher::onTextEdited);
+    mLineEdit->installEventFilter(this);
+}
+
+bool SearchDispatcher::isComposing() const
+{
+    return mComposing;
+}
+
+bool SearchDispatcher::isCurrent(quint64 generation) const
+{
+    return generation == mGeneration && !mComposing;
+}
+
+void SearchDispatcher::cancel()
+{
+    mDebounceTimer->stop();
+    mGeneration++;
+    mLastText.clear();
+}
+
+bool SearchDispatcher::eventFilter(QObject *watched, QEvent *event)
+{
+    if(watched == mLineEdit && event->type() == QEvent::InputMethod)
+    {
+        // 有预编辑文字表示正在组字，预编辑文字清空表示上屏或放弃组字
+        const QInputMethodEvent *imeEvent = static_cast<const QInputMethodEvent *>(event);
+        bool composing = !imeEvent->preeditString().isEmpty();
+        if(composing && !mComposing)
+        {
+            // 开始组字时停止等待中的查询，组字结束后重新分发
+            mDebounceTimer->stop();
+            mLastText.clear();
+        }
+        else if(!composing && mComposing)
+        {
+            // 放弃组字时文字没有变化，不会再收到textEdited，这里补一次分发
+            mDebounceTimer->start();
+        }
+        mComposing = composing;
+    }
+    // 不拦截事件，输入框照常处理
+    return QObject::eventFilter(watched, event);
+}
+
+void SearchDispatcher::onTextEdited()
+{
+    // 组字期间部分输入法会把拼音字母直接写入输入框，这些文字不是真正的查询
+    if(mComposing)
+    {
+        return;
+    }
+    mDebounceTimer->start();
+}
+
+void SearchDispatcher::dispatch()
+{
+    QString text = mLineEdit->text().trimmed();
+    if(mComposing || text == mLastText)
+    {
+        return;
+    }
+    mLastText = text;
+    mGeneration++;
+    emit queryReady(text, mGeneration);
+}
@@ -0,0 +1,101 @@
+/**
+ * @file searchdispatcher.h
+ * @brief 搜索框输入分发类的头文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 该文件定义了SearchDispatcher类，把搜索框的逐键输入整理为实时查询。
+ * 中文输入法组字期间的拼音串不是真正的查询，只有上屏后的文字才会被分发；
+ * 连续输入合并为一次查询，过期的查询结果被丢弃。
+ */
+
+#ifndef SEARCHDISPATCHER_H
+#define SEARCHDISPATCHER_H
+
+#include <QObject>          // Qt对象基类
+#include <QString>          // Qt字符串类
+
+class QEvent;
+class QLineEdit;
+class QTimer;
+
+/**
+ * @class SearchDispatcher
+ * @brief 支持输入法组字和防抖的搜索分发类
+ *
+ * 主要功能：
+ * - 监视输入框的输入法事件，组字期间不分发任何查询
+ * - 输入停止kDebounceMs毫秒后才分发，连续输入只查询最后的文字
+ * - 文字与上一次分发的相同时不重复查询
+ * - 每次分发带有递增的代号，查询结果返回时用isCurrent判断是否已过期
+ */
+class SearchDispatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 输入停止后等待的时间（毫秒）
+     */
+    static const int kDebounceMs = 150;
+
+    /**
+     * @brief 构造函数
+     * @param lineEdit 被监视的输入框
+     * @param parent 父对象指针
+     */
+    explicit SearchDispatcher(QLineEdit *lineEdit, QObject *parent = nullptr);
+
+    /**
+     * @brief 输入法是否正在组字
+     */
+    bool isComposing() const;
+
+    /**
+     * @brief 判断一次查询的结果是否仍然有效
+     * @param generation queryReady信号携带的代号
+     * @return 之后没有分发新的查询、没有被取消且不在组字时返回true
+     */
+    bool isCurrent(quint64 generation) const;
+
+    /**
+     * @brief 取消等待中的查询，并使已分发的查询全部过期
+     *
+     * 用户按下回车直接搜索时调用，之后返回的补全结果不再显示。
+     */
+    void cancel();
+
+signals:
+    /**
+     * @brief 输入稳定后发出
+     * @param text 去掉首尾空白的输入文字，可能为空
+     * @param generation 本次查询的代号
+     */
+    void queryReady(const QString &text, quint64 generation);
+
+protected:
+    /**
+     * @brief 监视输入框的输入法事件
+     */
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    /**
+     * @brief 用户修改了输入框文字
+     */
+    void onTextEdited();
+
+    /**
+     * @brief 防抖定时器到期，分发查询
+     */
+    void dispatch();
+
+private:
+    QLineEdit *mLineEdit;       // 被监视的输入框
+    QTimer *mDebounceTimer;     // 输入防抖定时器
+    QString mLastText;          // 上一次分发的文字
+    quint64 mGeneration;        // 最近一次分发或取消的代号
+    bool mComposing;            // 输入法是否正在组字
+};
+
+#endif // SEARCHDISPATCHER_H
@@ -0,0 +1,267 @@
+/**
+ * @file searchhistory.cpp
+ * @brief 城市搜索历史类的实现文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 文件格式（QDataStream，大端序）：
+ * - quint32 魔数 'WFSH'
+ * - quint16 版本号
+ * - quint16 记录条数
+ * - 每条记录：QByteArray 名称(UTF-8)、QByteArray 城市代码(UTF-8)、quint32 次数、qint64 最近使用时间
+ */
+
+#include "searchhistory.h"    // 搜索历史类头文件
+
+#include <QDataStream>        // 二进制序列化
+#include <QDateTime>          // 当前时间
+#include <QDebug>             // 调试输出
+#include <QDir>               // 创建历史文件所在目录
+#include <QFile>              // 读取历史文件
+#include <QFileInfo>          // 历史文件路径信息
+#include <QSaveFile>          // 原子写入历史文件
+#include <QSet>               // 排名列表去重
+#include <QTimer>             // 延迟写入定时器
+#include <QtConcurrent>       // 后台线程加载
+#include <QtMath>             // qPow
+
+#include <algorithm>          // std::sort
+
+// 历史文件魔数和版本号
+static const quint32 kHistoryMagic = 0x57465348;   // 'WFSH'
+static const quint16 kHistoryVersion = 1;
+
+// 修改后延迟写入的时间（毫秒）
+static const int kSaveDelayMs = 2000;
+
+// 排名分数的半衰期（秒），30天前的一次查询相当于今天的半次
+static const double kHalfLifeSeconds = 30.0 * 24 * 3600;
+
+SearchHistory::SearchHistory(const QString &filePath, QObject *parent)
+    : QObject(parent)
+    , mFilePath(filePath)
+    , mSaveTimer(new QTimer(this))
+    , mLoaded(false)
+{
+    mSaveTimer->setSingleShot(true);
+    mSaveTimer->setInterval(kSaveDelayMs);
+    connect(mSaveTimer, &QTimer::timeout, this, &SearchHistory::save);
+    connect(&mLoadWatcher, &QFutureWatcher<QVector<SearchHistoryEntry>>::finished,
+            this, &SearchHistory::onLoadFinished);
+}
+
+SearchHistory::~SearchHistory()
+{
+    // 退出前写入尚未保存的修改（只有加载完成后才会启动写入定时器）
+    if(mSaveTimer->isActive())
+    {
+        save();
+    }
+    mLoadWatcher.waitForFinished();
+}
+
+void SearchHistory::loadAsync()
+{
+    if(mLoaded || mLoadWatcher.isRunning())
+    {
+        return;
+    }
+    mLoadWatcher.setFuture(QtConcurrent::run(&SearchHistory::readFile, mFilePath));
+}
+
+bool SearchHistory::isLoaded() const
+{
+    return mLoaded;
+}
+
+QString SearchHistory::recall(const QString &name) const
+{
+    QHash<QString,int>::const_iterator it = mIndexByName.constFind(name);
+    return it == mIndexByName.constEnd() ? QString() : mEntries.at(it.value()).code;
+}
+
+void SearchHistory::record(const QString &name, const QString &code)
+{
+    qint64 now = QDateTime::currentSecsSinceEpoch();
+
+    QHash<QString,int>::const_iterator it = mIndexByName.constFind(name);
+    if(it != mIndexByName.constEnd())
+    {
+        SearchHistoryEntry &entry = mEntries[it.value()];
+        entry.code = code;
+        entry.count++;
+        entry.lastUsed = now;
+    }
+    else
+    {
+        SearchHistoryEntry entry;
+        entry.name = name;
+        entry.code = code;
+        entry.count = 1;
+        entry.lastUsed = now;
+        mEntries.append(entry);
+    }
+    reorder();
+
+    // 加载完成之前不写文件，避免覆盖尚未读取的历史
+    if(mLoaded)
+    {
+        mSaveTimer->start();
+    }
+}
+
+QVector<SearchHistoryEntry> SearchHistory::topEntries(int count) const
+{
+    QVector<SearchHistoryEntry> result;
+    QSet<QString> codes;
+    for(const SearchHistoryEntry &entry : mEntries)
+    {
+        if(result.size() >= count)
+        {
+            break;
+        }
+        // 不同名称可能指向同一城市，只保留排名最高的一条
+        if(!codes.contains(entry.code))
+        {
+            codes.insert(entry.code);
+            result.append(entry);
+        }
+    }
+    return result;
+}
+
+QStringList SearchHistory::names() const
+{
+    QStringList result;
+    result.reserve(mEntries.size());
+    for(const SearchHistoryEntry &entry : mEntries)
+    {
+        result.append(entry.name);
+    }
+    return result;
+}
+
+void SearchHistory::onLoadFinished()
+{
+    QVector<SearchHistoryEntry> entries = mLoadWatcher.result();
+    mLoaded = true;
+
+    // 合并加载期间产生的新记录
+    for(const SearchHistoryEntry &pending : mEntries)
+    {
+        bool merged = false;
+        for(SearchHistoryEntry &entry : entries)
+        {
+            if(entry.name == pending.name)
+            {
+                entry.code = pending.code;
+                entry.count += pending.count;
+                entry.lastUsed = qMax(entry.lastUsed, pending.lastUsed);
+                merged = true;
+                break;
+            }
+        }
+        if(!merged)
+        {
+            entries.append(pending);
+        }
+    }
+    bool hasPending = !mEntries.isEmpty();
+
+    mEntries = entries;
+    reorder();
+    if(hasPending)
+    {
+        mSaveTimer->start();
+    }
+    emit loaded();
+}
+
+void SearchHistory::save()
+{
+    QDir().mkpath(QFileInfo(mFilePath).absolutePath());
+
+    QSaveFile file(mFilePath);
+    if(!file.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "无法写入搜索历史:" << mFilePath << file.errorString();
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << kHistoryMagic << kHistoryVersion << static_cast<quint16>(mEntries.size());
+    for(const SearchHistoryEntry &entry : mEntries)
+    {
+        out << entry.name.toUtf8() << entry.code.toUtf8() << entry.count << entry.lastUsed;
+    }
+    file.commit();
+}
+
+QVector<SearchHistoryEntry> SearchHistory::readFile(const QString &filePath)
+{
+    QVector<SearchHistoryEntry> entries;
+
+    QFile file(filePath);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return entries;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint16 count = 0;
+    in >> magic >> version >> count;
+    if(magic != kHistoryMagic || version != kHistoryVersion)
+    {
+        return entries;
+    }
+
+    entries.reserve(count);
+    for(int i = 0; i < count && in.status() == QDataStream::Ok; i++)
+    {
+        QByteArray name;
+        QByteArray code;
+        SearchHistoryEntry entry;
+        in >> name >> code >> entry.count >> entry.lastUsed;
+        entry.name = QString::fromUtf8(name);
+        entry.code = QString::fromUtf8(code);
+        entries.append(entry);
+    }
+
+    // 文件损坏时丢弃全部内容，不使用读了一半的数据
+    if(in.status() != QDataStream::Ok)
+    {
+        entries.clear();
+    }
+    return entries;
+}
+
+double SearchHistory::score(const SearchHistoryEntry &entry, qint64 now)
+{
+    // 查询次数随时间指数衰减，兼顾频率和最近使用
+    double age = qMax<qint64>(0, now - entry.lastUsed);
+    return entry.count * qPow(0.5, age / kHalfLifeSeconds);
+}
+
+void SearchHistory::reorder()
+{
+    qint64 now = QDateTime::currentSecsSinceEpoch();
+    std::sort(mEntries.begin(), mEntries.end(),
+              [now](const SearchHistoryEntry &a, const SearchHistoryEntry &b) {
+        return score(a, now) > score(b, now);
+    });
+    if(mEntries.size() > kMaxEntries)
+    {
+        mEntries.resize(kMaxEntries);
+    }
+
+    mIndexByName.clear();
+    for(int i = 0; i < mEntries.size(); i++)
+    {
+        mIndexByName.insert(mEntries[i].name, i);
+    }
+}
@@ -0,0 +1,147 @@
+/**
+ * @file searchhistory.h
+ * @brief 城市搜索历史类的头文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 该文件定义了SearchHistory类，持久化保存用户查询过的城市。
+ * 历史记录按使用频率和最近使用时间排序，启动时在后台线程加载，
+ * 用于在搜索框中直接召回城市代码，以及在启动时预取常用城市的天气。
+ */
+
+#ifndef SEARCHHISTORY_H
+#define SEARCHHISTORY_H
+
+#include <QObject>          // Qt对象基类
+#include <QHash>            // 名称到记录的哈希索引
+#include <QString>          // Qt字符串类
+#include <QStringList>      // 名称列表
+#include <QVector>          // 历史记录列表
+#include <QFutureWatcher>   // 监视后台加载任务
+
+class QTimer;
+
+/**
+ * @struct SearchHistoryEntry
+ * @brief 一条搜索历史记录
+ */
+struct SearchHistoryEntry
+{
+    QString name;       // 用户输入的城市名称
+    QString code;       // 解析得到的城市代码
+    quint32 count;      // 查询次数
+    qint64 lastUsed;    // 最近一次查询的时间（自1970年起的秒数）
+};
+
+/**
+ * @class SearchHistory
+ * @brief 持久化的城市搜索历史
+ *
+ * 主要功能：
+ * - 按名称O(1)召回城市代码，命中时无需加载城市索引
+ * - 记录每次成功的查询，综合频率和最近使用时间排序
+ * - 以紧凑的二进制格式保存，最多保留kMaxEntries条
+ * - 启动时在后台线程加载，加载完成后发出loaded信号
+ */
+class SearchHistory : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 最多保留的历史记录条数
+     */
+    static const int kMaxEntries = 64;
+
+    /**
+     * @brief 构造函数
+     * @param filePath 历史记录文件路径
+     * @param parent 父对象指针
+     */
+    explicit SearchHistory(const QString &filePath, QObject *parent = nullptr);
+
+    /**
+     * @brief 析构函数，保存尚未写入的修改
+     */
+    ~SearchHistory();
+
+    /**
+     * @brief 在后台线程加载历史记录文件
+     */
+    void loadAsync();
+
+    /**
+     * @brief 历史记录是否已加载完成
+     */
+    bool isLoaded() const;
+
+    /**
+     * @brief 按名称召回城市代码
+     * @param name 用户输入的城市名称
+     * @return 城市代码，名称不在历史记录中时返回空字符串
+     */
+    QString recall(const QString &name) const;
+
+    /**
+     * @brief 记录一次成功的查询
+     * @param name 用户输入的城市名称
+     * @param code 解析得到的城市代码
+     *
+     * 修改会延迟一小段时间后写入文件，连续查询只写一次。
+     */
+    void record(const QString &name, const QString &code);
+
+    /**
+     * @brief 获取排名最高的若干条记录
+     * @param count 最多返回的条数
+     * @return 按排名从高到低排列的记录，不包含城市代码重复的记录
+     */
+    QVector<SearchHistoryEntry> topEntries(int count) const;
+
+    /**
+     * @brief 获取全部历史名称，按排名从高到低排列，用于搜索框自动补全
+     */
+    QStringList names() const;
+
+signals:
+    /**
+     * @brief 后台加载完成后发出
+     */
+    void loaded();
+
+private slots:
+    /**
+     * @brief 后台加载任务完成，合并加载期间产生的新记录
+     */
+    void onLoadFinished();
+
+    /**
+     * @brief 将历史记录写入文件
+     */
+    void save();
+
+private:
+    /**
+     * @brief 从文件读取历史记录，在后台线程执行
+     */
+    static QVector<SearchHistoryEntry> readFile(const QString &filePath);
+
+    /**
+     * @brief 计算记录的排名分数
+     */
+    static double score(const SearchHistoryEntry &entry, qint64 now);
+
+    /**
+     * @brief 按排名重新排序、截断并重建名称索引
+     */
+    void reorder();
+
+    QString mFilePath;                                          // 历史记录文件路径
+    QVector<SearchHistoryEntry> mEntries;                       // 按排名排序的记录
+    QHash<QString,int> mIndexByName;                            // 名称到mEntries下标的索引
+    QFutureWatcher<QVector<SearchHistoryEntry>> mLoadWatcher;   // 后台加载任务监视器
+    QTimer *mSaveTimer;                                         // 延迟写入定时器
+    bool mLoaded;                                               // 是否已加载完成
+};
+
+#endif // SEARCHHISTORY_H
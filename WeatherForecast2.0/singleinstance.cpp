@@ -0,0 +1,112 @@
+/**
+ * @file singleinstance.cpp
+ * @brief 单实例运行守护类的实现文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 转发协议：客户端连接后用QDataStream写入一个QStringList，随后断开连接。
+ */
+
+#include "singleinstance.h"   // 单实例守护类头文件
+
+#include <QCryptographicHash> // 生成与用户相关的套接字名称
+#include <QDataStream>        // 参数序列化
+#include <QDir>               // 获取用户主目录
+#include <QLocalServer>       // 本地服务器
+#include <QLocalSocket>       // 本地套接字
+
+// 连接和写入的超时时间（毫秒），已运行实例无响应时不应长时间阻塞启动
+static const int kConnectTimeoutMs = 500;
+
+SingleInstance::SingleInstance(const QString &key, QObject *parent)
+    : QObject(parent)
+    , mServer(nullptr)
+{
+    // 套接字名称包含用户主目录的摘要，不同用户之间互不影响
+    QByteArray userHash = QCryptographicHash::hash(QDir::homePath().toUtf8(),
+                                                   QCryptographicHash::Sha1).toHex().left(12);
+    mServerName = key + "-" + QString::fromLatin1(userHash);
+}
+
+bool SingleInstance::sendToRunningInstance(const QStringList &arguments)
+{
+    QLocalSocket socket;
+    socket.connectToServer(mServerName);
+    if(!socket.waitForConnected(kConnectTimeoutMs))
+    {
+        // 连接失败说明没有正在运行的实例
+        return false;
+    }
+
+    QByteArray block;
+    QDataStream out(&block, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << arguments;
+
+    socket.write(block);
+    if(!socket.waitForBytesWritten(kConnectTimeoutMs))
+    {
+        return false;
+    }
+    socket.disconnectFromServer();
+    return true;
+}
+
+bool SingleInstance::listen()
+{
+    mServer = new QLocalServer(this);
+    connect(mServer, &QLocalServer::newConnection, this, &SingleInstance::onNewConnection);
+
+    if(mServer->listen(mServerName))
+    {
+        return true;
+    }
+
+    // 名称已被占用：可能是上次进程异常退出残留的套接字文件，
+    // 也可能是同时启动的另一个实例刚刚开始监听。
+    // 再连接一次，有实例应答时不能删除它的套接字，只有无人应答时才清理后重试
+    if(mServer->serverError() == QAbstractSocket::AddressInUseError)
+    {
+        QLocalSocket probe;
+        probe.connectToServer(mServerName);
+        if(probe.waitForConnected(kConnectTimeoutMs))
+        {
+            probe.disconnectFromServer();
+            return false;
+        }
+        QLocalServer::removeServer(mServerName);
+        return mServer->listen(mServerName);
+    }
+    return false;
+}
+
+void SingleInstance::onNewConnection()
+{
+    while(QLocalSocket *socket = mServer->nextPendingConnection())
+    {
+        // 参数可能分多次到达，使用读事务直到读取到完整的列表
+        auto readArguments = [this, socket]{
+            QDataStream in(socket);
+            in.setVersion(QDataStream::Qt_5_0);
+            in.startTransaction();
+
+            QStringList arguments;
+            in >> arguments;
+            if(!in.commitTransaction())
+            {
+                return;
+            }
+            socket->disconnect(this);
+            socket->deleteLater();
+            emit messageReceived(arguments);
+        };
+        connect(socket, &QLocalSocket::readyRead, this, readArguments);
+        connect(socket, &QLocalSocket::disconnected, socket, &QLocalSocket::deleteLater);
+
+        // 连接建立前到达的数据不会再触发readyRead，需要主动读取一次
+        if(socket->bytesAvailable() > 0)
+        {
+            readArguments();
+        }
+    }
+}
@@ -0,0 +1,75 @@
+/**
+ * @file singleinstance.h
+ * @brief 单实例运行守护类的头文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 该文件定义了SingleInstance类，基于本地套接字(QLocalServer/QLocalSocket)
+ * 保证同一用户只运行一个天气预报程序实例。重复启动时，新进程把命令行参数
+ * 转发给已运行的实例后立即退出，不再重复加载城市数据、图标和网络连接。
+ */
+
+#ifndef SINGLEINSTANCE_H
+#define SINGLEINSTANCE_H
+
+#include <QObject>          // Qt对象基类
+#include <QString>          // Qt字符串类
+#include <QStringList>      // 命令行参数列表
+
+class QLocalServer;
+
+/**
+ * @class SingleInstance
+ * @brief 单实例运行守护类
+ *
+ * 使用方式：
+ * 1. 启动时调用sendToRunningInstance()，返回true说明已有实例在运行，
+ *    参数已转发成功，当前进程应直接退出
+ * 2. 否则调用listen()成为主实例，之后其他进程转发的参数
+ *    通过messageReceived信号送达
+ */
+class SingleInstance : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造函数
+     * @param key 实例标识，同一标识的进程之间互斥
+     * @param parent 父对象指针
+     */
+    explicit SingleInstance(const QString &key, QObject *parent = nullptr);
+
+    /**
+     * @brief 尝试把参数转发给已运行的实例
+     * @param arguments 要转发的完整命令行参数
+     * @return true表示已有实例在运行且转发成功
+     */
+    bool sendToRunningInstance(const QStringList &arguments);
+
+    /**
+     * @brief 开始监听，成为主实例
+     * @return 监听是否成功；与另一个实例同时启动、对方已先开始监听时返回false，
+     *         此时应再次调用sendToRunningInstance()把参数转发给对方
+     */
+    bool listen();
+
+signals:
+    /**
+     * @brief 收到其他进程转发的参数
+     * @param arguments 转发的命令行参数
+     */
+    void messageReceived(const QStringList &arguments);
+
+private slots:
+    /**
+     * @brief 有新的本地连接到达，读取其转发的参数
+     */
+    void onNewConnection();
+
+private:
+    QString mServerName;        // 本地套接字名称
+    QLocalServer *mServer;      // 主实例的本地服务器
+};
+
+#endif // SINGLEINSTANCE_H
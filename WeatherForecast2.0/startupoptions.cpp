@@ -0,0 +1,160 @@
+/**
+ * @file startupoptions.cpp
+ * @brief 启动参数解析类的实现文件
+ * @author Weather Forecast Team
+ * @date 2025
+ */
+
+#include "startupoptions.h"   // 启动参数解析类头文件
+
+#include <QCommandLineParser> // 命令行解析器
+#include <QUrl>               // URL协议参数解析
+
+// 程序使用的URL协议名称
+static const char kUrlScheme[] = "weatherforecast";
+
+/**
+ * @brief 城市代码是否恰好为9位ASCII数字，如"101010100"
+ *
+ * 城市代码可能来自任意网页触发的URL协议，解码后会被拼入请求URL，
+ * 只接受固定格式，拒绝"%26appid%3D"之类附带额外参数的内容。
+ */
+static bool isValidCityCode(const QString &code)
+{
+    if(code.length() != 9)
+    {
+        return false;
+    }
+    for(QChar ch : code)
+    {
+        if(ch < QLatin1Char('0') || ch > QLatin1Char('9'))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 配置命令行解析器支持的选项
+ * @param parser 要配置的解析器
+ */
+static void setupParser(QCommandLineParser &parser)
+{
+    parser.setApplicationDescription("天气预报桌面应用程序");
+    parser.addHelpOption();
+    parser.addOption(QCommandLineOption("city", "启动时显示指定名称的城市。", "名称"));
+    parser.addOption(QCommandLineOption("code", "启动时显示指定代码的城市。", "代码"));
+    parser.addOption(QCommandLineOption("offline", "离线模式，不发起任何网络请求。"
+                                                   "程序已在运行时使其切换到离线模式，直到重新启动。"));
+    parser.addOption(QCommandLineOption("no-fetch", "不请求天气，等待用户搜索；同时指定城市名称时"
+                                                    "只填入搜索框，城市代码被忽略。"
+                                                    "程序已在运行时同样生效。"));
+    parser.addPositionalArgument("city", "城市名称或weatherforecast://city/<名称>、"
+                                         "weatherforecast://code/<代码>形式的URL。", "[城市]");
+}
+
+/**
+ * @brief 解析weatherforecast://形式的URL
+ * @param url URL字符串
+ * @param options 解析结果
+ * @return URL格式是否有效
+ */
+static bool parseSchemeUrl(const QString &url, StartupOptions *options)
+{
+    QUrl parsed(url);
+    QString value = parsed.path(QUrl::FullyDecoded).mid(1);   // 去掉路径开头的"/"
+    if(value.isEmpty())
+    {
+        return false;
+    }
+
+    if(parsed.host() == "city")
+    {
+        options->cityName = value;
+        return true;
+    }
+    if(parsed.host() == "code")
+    {
+        if(!isValidCityCode(value))
+        {
+            return false;
+        }
+        options->cityCode = value;
+        return true;
+    }
+    return false;
+}
+
+StartupOptions::StartupOptions()
+    : offline(false)
+    , noFetch(false)
+    , helpRequested(false)
+{
+}
+
+bool StartupOptions::parse(const QStringList &arguments, StartupOptions *options,
+                           QString *errorMessage)
+{
+    QCommandLineParser parser;
+    setupParser(parser);
+
+    *options = StartupOptions();
+    if(!parser.parse(arguments))
+    {
+        if(errorMessage)
+        {
+            *errorMessage = parser.errorText();
+        }
+        return false;
+    }
+
+    options->helpRequested = parser.isSet("help");
+    options->offline = parser.isSet("offline");
+    options->noFetch = parser.isSet("no-fetch");
+    options->cityName = parser.value("city").trimmed();
+    options->cityCode = parser.value("code").trimmed();
+    if(!options->cityCode.isEmpty() && !isValidCityCode(options->cityCode))
+    {
+        if(errorMessage)
+        {
+            *errorMessage = QString("城市代码必须是9位数字: %1").arg(options->cityCode);
+        }
+        return false;
+    }
+
+    // 位置参数：URL协议或城市名称，显式选项优先
+    const QStringList positional = parser.positionalArguments();
+    if(!positional.isEmpty() && !options->hasCity())
+    {
+        QString argument = positional.first().trimmed();
+        if(argument.startsWith(QString(kUrlScheme) + ":"))
+        {
+            if(!parseSchemeUrl(argument, options))
+            {
+                if(errorMessage)
+                {
+                    *errorMessage = QString("无法识别的URL: %1").arg(argument);
+                }
+                return false;
+            }
+        }
+        else
+        {
+            options->cityName = argument;
+        }
+    }
+    return true;
+}
+
+QString StartupOptions::helpText()
+{
+    QCommandLineParser parser;
+    setupParser(parser);
+    return parser.helpText();
+}
+
+bool StartupOptions::hasCity() const
+{
+    return !cityName.isEmpty() || !cityCode.isEmpty();
+}
@@ -0,0 +1,67 @@
+/**
+ * @file startupoptions.h
+ * @brief 启动参数解析类的头文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 该文件定义了StartupOptions类，使用QCommandLineParser解析启动参数，
+ * 使程序启动时的首个请求直接指向目标城市，而不是先请求默认城市。
+ *
+ * 支持的参数：
+ * - --city <名称>   按城市名称选择城市
+ * - --code <代码>   按城市代码选择城市，必须是9位数字
+ * - --offline       离线模式，不发起任何网络请求
+ * - --no-fetch      不请求天气，等待用户搜索；同时指定城市名称时只填入搜索框
+ * - 位置参数：城市名称，或 weatherforecast://city/<名称>、
+ *   weatherforecast://code/<代码> 形式的URL
+ */
+
+#ifndef STARTUPOPTIONS_H
+#define STARTUPOPTIONS_H
+
+#include <QString>          // Qt字符串类
+#include <QStringList>      // 命令行参数列表
+
+/**
+ * @class StartupOptions
+ * @brief 启动参数
+ *
+ * 首次启动和单实例转发的参数使用同一套解析规则，也按同样的含义生效：
+ * 转发的--offline使已运行的实例进入离线模式，转发的--no-fetch使指定的城市不被请求。
+ */
+class StartupOptions
+{
+public:
+    /**
+     * @brief 默认构造函数，所有选项为未设置状态
+     */
+    StartupOptions();
+
+    /**
+     * @brief 解析命令行参数
+     * @param arguments 完整的命令行参数（第一项为程序名）
+     * @param options 解析结果
+     * @param errorMessage 解析失败时写入失败原因，可为nullptr
+     * @return 解析是否成功
+     */
+    static bool parse(const QStringList &arguments, StartupOptions *options,
+                      QString *errorMessage = nullptr);
+
+    /**
+     * @brief 获取命令行帮助文本
+     */
+    static QString helpText();
+
+    /**
+     * @brief 是否指定了要显示的城市
+     */
+    bool hasCity() const;
+
+    QString cityName;       // 城市名称（--city或位置参数）
+    QString cityCode;       // 城市代码（--code或URL），优先于城市名称，已校验为9位数字
+    bool offline;           // 离线模式，不发起网络请求
+    bool noFetch;           // 不请求天气，包括指定的城市
+    bool helpRequested;     // 请求显示帮助信息
+};
+
+#endif // STARTUPOPTIONS_H
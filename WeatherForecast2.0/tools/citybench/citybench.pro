@@ -0,0 +1,37 @@
+# 城市索引基准测试程序
+#
+# 在命令行中读取一份城市数据，建立与程序相同的城市索引，
+# 输出读取和建立索引的耗时、内存占用以及名称查询的吞吐量。
+# 通常由 tools/run_city_bench.py 在2.5k、100k、1M三种规模下依次调用。
+#
+# 构建：
+#     cd tools/citybench && qmake && make
+#
+# 只包含城市索引相关的源文件，不依赖界面和网络模块。
+
+QT       += core concurrent
+QT       -= gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = citybench
+
+SRC = ../..
+INCLUDEPATH += $$SRC
+
+SOURCES += \
+    main.cpp \
+    $$SRC/citycodeutils.cpp \
+    $$SRC/citydatareader.cpp \
+    $$SRC/geoindex.cpp \
+    $$SRC/jsonscan.cpp
+
+HEADERS += \
+    $$SRC/citycodeutils.h \
+    $$SRC/citydatareader.h \
+    $$SRC/geoindex.h \
+    $$SRC/jsonscan.h
+
+# Windows下读取进程内存占用
+win32: LIBS += -lpsapi
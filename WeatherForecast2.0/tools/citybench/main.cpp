@@ -0,0 +1,291 @@
+/**
+ * @file main.cpp
+ * @brief 城市索引基准测试程序
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 用法：
+ *     citybench 城市数据文件 [查询次数]
+ *
+ * 按程序中的流程读取城市数据（CityCodeUtils::readCityData）并建立索引
+ * （CityCodeUtils::build），然后从数据中均匀抽取城市名称，测量名称查询
+ * （getCityCodeFromName）和候选城市查询（getCityCandidates）的平均耗时；
+ * 数据带有坐标时（tools/gen_city_dataset.py生成的数据都带有合成坐标），
+ * 另外在中国范围内取固定种子的随机坐标，测量空间索引的三种坐标查询。
+ *
+ * 输出一行"键=值"形式的结果，便于脚本汇总：
+ *     records       记录数
+ *     read_ms       读取和扫描数据的耗时
+ *     build_ms      建立索引的耗时
+ *     rss_kb        建立索引并释放原始记录后，进程常驻内存相对启动时的增量
+ *     peak_rss_kb   进程常驻内存的峰值
+ *     lookup_ns     每次名称查询的平均耗时
+ *     candidates_ns 每次候选城市查询的平均耗时
+ *     miss_ns       每次查询不存在的名称的平均耗时
+ *     hit_rate      抽样名称的命中比例
+ *     located       带坐标的城市数，为0时不测量坐标查询
+ *     nearest_ns    每次最近城市查询（nearestCityCode）的平均耗时
+ *     nearest5_ns   每次最近5个城市查询（nearestCities）的平均耗时
+ *     radius_ns     每次50千米半径查询（citiesWithinRadius）的平均耗时
+ *     radius_hits   半径查询平均返回的城市数
+ *     geo_found     最近城市查询的结果总数，防止查询被优化掉
+ */
+
+#include "citycodeutils.h"    // 城市索引
+
+#include <QCoreApplication>   // 应用程序核心功能
+#include <QElapsedTimer>      // 计时
+#include <QFileInfo>          // 数据文件是否存在
+#include <QPair>              // 查询坐标
+#include <QTextStream>        // 标准输出
+#include <QtNumeric>          // qIsNaN，缺失坐标
+
+#include <cstdio>             // fopen，读取/proc
+#include <random>             // 固定种子的随机查询坐标
+
+#if defined(Q_OS_WIN)
+#include <windows.h>          // GetCurrentProcess
+#include <psapi.h>            // GetProcessMemoryInfo
+#endif
+
+// 默认的查询次数
+static const int kDefaultLookups = 200000;
+
+// 最多抽取的不同名称数
+static const int kMaxSampleNames = 4096;
+
+// 随机查询坐标的个数
+static const int kQueryPoints = 4096;
+
+// 半径查询的半径（千米），约为一个地级市的范围
+static const double kQueryRadiusKm = 50.0;
+
+/**
+ * @brief 读取进程的常驻内存（KB）
+ * @param peak 为true时读取峰值
+ * @return 常驻内存，当前平台不支持时返回0
+ */
+static qint64 residentKb(bool peak)
+{
+#if defined(Q_OS_LINUX)
+    FILE *file = fopen("/proc/self/status", "r");
+    if(!file)
+    {
+        return 0;
+    }
+    const char *key = peak ? "VmHWM:" : "VmRSS:";
+    char line[256];
+    qint64 value = 0;
+    while(fgets(line, sizeof(line), file))
+    {
+        if(qstrncmp(line, key, qstrlen(key)) == 0)
+        {
+            value = QByteArray(line + qstrlen(key)).trimmed().split(' ').first().toLongLong();
+            break;
+        }
+    }
+    fclose(file);
+    return value;
+#elif defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return 0;
+    }
+    return static_cast<qint64>(peak ? counters.PeakWorkingSetSize : counters.WorkingSetSize) / 1024;
+#else
+    Q_UNUSED(peak);
+    return 0;
+#endif
+}
+
+/**
+ * @brief 从数据块中均匀抽取城市名称
+ */
+static QStringList sampleNames(const QVector<CityDataChunk> &chunks, int total)
+{
+    QStringList names;
+    int step = qMax(1, total / kMaxSampleNames);
+    int index = 0;
+    for(const CityDataChunk &chunk : chunks)
+    {
+        for(const CityDataRecord &record : chunk.records)
+        {
+            if(index++ % step == 0)
+            {
+                names.append(QString::fromUtf8(chunk.namePool.constData() + record.nameOffset,
+                                                record.nameLength));
+            }
+        }
+    }
+    return names;
+}
+
+/**
+ * @brief 统计带坐标的城市记录数
+ */
+static int countLocated(const QVector<CityDataChunk> &chunks)
+{
+    int located = 0;
+    for(const CityDataChunk &chunk : chunks)
+    {
+        for(const CityDataRecord &record : chunk.records)
+        {
+            if(!qIsNaN(record.latitude) && !qIsNaN(record.longitude))
+            {
+                located++;
+            }
+        }
+    }
+    return located;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QStringList arguments = a.arguments();
+    if(arguments.size() < 2 || !QFileInfo::exists(arguments.at(1)))
+    {
+        err << "用法: citybench 城市数据文件 [查询次数]\n";
+        return 1;
+    }
+    int lookups = arguments.size() > 2 ? arguments.at(2).toInt() : kDefaultLookups;
+    if(lookups <= 0)
+    {
+        lookups = kDefaultLookups;
+    }
+
+    qint64 baseKb = residentKb(false);
+    QElapsedTimer timer;
+
+    // 读取和扫描数据
+    timer.start();
+    QVector<CityDataChunk> chunks = CityCodeUtils::readCityData(arguments.at(1));
+    qint64 readMs = timer.elapsed();
+
+    int records = 0;
+    for(const CityDataChunk &chunk : chunks)
+    {
+        records += chunk.records.size();
+    }
+    int located = countLocated(chunks);
+    QStringList names = sampleNames(chunks, records);
+    if(names.isEmpty())
+    {
+        err << "数据文件中没有城市记录\n";
+        return 1;
+    }
+
+    // 建立索引，之后释放原始记录，只保留索引本身
+    CityCodeUtils index;
+    timer.restart();
+    index.build(chunks);
+    qint64 buildMs = timer.elapsed();
+    chunks.clear();
+    qint64 indexKb = residentKb(false) - baseKb;
+
+    // 名称查询：循环使用抽样名称，结果累计到hits防止被优化掉
+    int hits = 0;
+    timer.restart();
+    for(int i = 0; i < lookups; i++)
+    {
+        if(!index.getCityCodeFromName(names.at(i % names.size())).isEmpty())
+        {
+            hits++;
+        }
+    }
+    double lookupNs = static_cast<double>(timer.nsecsElapsed()) / lookups;
+
+    // 候选城市查询，返回全部同名城市
+    int candidateCount = 0;
+    timer.restart();
+    for(int i = 0; i < lookups; i++)
+    {
+        candidateCount += index.getCityCandidates(names.at(i % names.size())).size();
+    }
+    double candidatesNs = static_cast<double>(timer.nsecsElapsed()) / lookups;
+
+    // 不存在的名称，走完名称索引和词干索引两次查找
+    const QString missing = QStringLiteral("不存在的城市名称");
+    int misses = 0;
+    timer.restart();
+    for(int i = 0; i < lookups; i++)
+    {
+        if(index.getCityCodeFromName(missing).isEmpty())
+        {
+            misses++;
+        }
+    }
+    double missNs = static_cast<double>(timer.nsecsElapsed()) / lookups;
+
+    // 坐标查询：查询点在中国范围内均匀分布，与gen_city_dataset.py的合成坐标范围一致
+    double nearestNs = 0;
+    double nearest5Ns = 0;
+    double radiusNs = 0;
+    double radiusHits = 0;
+    qint64 geoFound = 0;
+    if(located > 0)
+    {
+        std::mt19937 random(20250101);
+        std::uniform_real_distribution<double> latitudes(18.0, 54.0);
+        std::uniform_real_distribution<double> longitudes(73.0, 135.0);
+        QVector<QPair<double,double>> points;
+        points.reserve(kQueryPoints);
+        for(int i = 0; i < kQueryPoints; i++)
+        {
+            double latitude = latitudes(random);
+            points.append(qMakePair(latitude, longitudes(random)));
+        }
+
+        timer.restart();
+        for(int i = 0; i < lookups; i++)
+        {
+            const QPair<double,double> &point = points.at(i % kQueryPoints);
+            if(!index.nearestCityCode(point.first, point.second).isEmpty())
+            {
+                geoFound++;
+            }
+        }
+        nearestNs = static_cast<double>(timer.nsecsElapsed()) / lookups;
+
+        timer.restart();
+        for(int i = 0; i < lookups; i++)
+        {
+            const QPair<double,double> &point = points.at(i % kQueryPoints);
+            geoFound += index.nearestCities(point.first, point.second, 5).size();
+        }
+        nearest5Ns = static_cast<double>(timer.nsecsElapsed()) / lookups;
+
+        timer.restart();
+        for(int i = 0; i < lookups; i++)
+        {
+            const QPair<double,double> &point = points.at(i % kQueryPoints);
+            radiusHits += index.citiesWithinRadius(point.first, point.second, kQueryRadiusKm).size();
+        }
+        radiusNs = static_cast<double>(timer.nsecsElapsed()) / lookups;
+        radiusHits /= lookups;
+    }
+
+    out << "records=" << records
+        << " read_ms=" << readMs
+        << " build_ms=" << buildMs
+        << " rss_kb=" << indexKb
+        << " peak_rss_kb=" << residentKb(true)
+        << " lookup_ns=" << QString::number(lookupNs, 'f', 1)
+        << " candidates_ns=" << QString::number(candidatesNs, 'f', 1)
+        << " miss_ns=" << QString::number(missNs, 'f', 1)
+        << " hit_rate=" << QString::number(static_cast<double>(hits) / lookups, 'f', 3)
+        << " candidates=" << candidateCount
+        << " misses=" << misses
+        << " located=" << located
+        << " nearest_ns=" << QString::number(nearestNs, 'f', 1)
+        << " nearest5_ns=" << QString::number(nearest5Ns, 'f', 1)
+        << " radius_ns=" << QString::number(radiusNs, 'f', 1)
+        << " radius_hits=" << QString::number(radiusHits, 'f', 1)
+        << " geo_found=" << geoFound
+        << "\n";
+    return 0;
+}
@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+@file gen_city_dataset.py
+@brief 生成指定规模的合成城市数据，用于测量城市索引的建立时间和内存占用
+
+以citycode.min.json为种子，按原有的省-市-县层级复制出指定数量的记录，
+名称加上序号后缀以产生足够多的不同名称和词干，字段格式与打包数据一致。
+每条记录另外带有固定随机种子生成的lat、lon（中国范围内均匀分布），
+用于测量空间索引的建立时间和坐标查询速度；坐标是合成的，不能用于实际数据。
+
+用法：
+    python3 tools/gen_city_dataset.py 数量 输出文件
+
+例如分别生成2.5k、100k、1M条记录：
+    python3 tools/gen_city_dataset.py 2500 /tmp/city_2k5.json
+    python3 tools/gen_city_dataset.py 100000 /tmp/city_100k.json
+    python3 tools/gen_city_dataset.py 1000000 /tmp/city_1m.json
+
+生成的文件由tools/citybench读取并建立索引，测量耗时、内存和查询速度；
+tools/run_city_bench.py会自动生成三种规模的数据并汇总结果。
+"""
+
+import json
+import os
+import random
+import sys
+
+# 合成坐标的范围（纬度、经度，度），大致覆盖中国
+LAT_RANGE = (18.0, 54.0)
+LON_RANGE = (73.0, 135.0)
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__)
+        sys.exit(1)
+
+    count = int(sys.argv[1])
+    dst = sys.argv[2]
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    with open(os.path.join(root, "citycode.min.json"), encoding="utf-8") as f:
+        seed = json.load(f)
+
+    # 每一轮复制整份种子数据，id整体偏移，pid保持指向同一轮内的上级
+    span = max(city["id"] for city in seed)
+    rng = random.Random(20250101)
+    cities = []
+    round_index = 0
+    while len(cities) < count:
+        offset = round_index * span
+        for city in seed:
+            if len(cities) >= count:
+                break
+            copy = dict(city)
+            copy["id"] = city["id"] + offset
+            copy["pid"] = city["pid"] + offset if city["pid"] else 0
+            if round_index:
+                # 序号插在行政区划后缀之前，保持后缀可被去掉
+                name = city["city_name"]
+                copy["city_name"] = name[:-1] + str(round_index) + name[-1:]
+            copy["lat"] = round(rng.uniform(*LAT_RANGE), 4)
+            copy["lon"] = round(rng.uniform(*LON_RANGE), 4)
+            cities.append(copy)
+        round_index += 1
+
+    data = json.dumps(cities, ensure_ascii=False, separators=(",", ":")).encode("utf-8")
+    with open(dst, "wb") as f:
+        f.write(data)
+
+    print("%s: %d 条记录, %d 字节" % (os.path.basename(dst), len(cities), len(data)))
+
+
+if __name__ == "__main__":
+    main()
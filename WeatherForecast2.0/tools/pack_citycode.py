@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+@file pack_citycode.py
+@brief 生成打包进资源文件的精简版城市代码数据
+
+citycode.json是带缩进的原始数据，其中post_code、area_code、ctime等字段
+程序并不使用。该脚本只保留程序读取的字段（id、pid、city_code、city_name
+以及可选的population、lat、lon），去掉所有空白，生成
+citycode.min.json，由citycode.qrc以":/citycode.json"的别名打包。
+
+坐标不在citycode.json中维护，而是放在同目录的citygeo.csv（存在时自动合并），
+每行为"city_code,lat,lon"，以#开头的行为注释。带坐标的城市由程序加入空间索引，
+支持按GPS坐标查询最近的预报城市。
+
+用法：
+    python3 tools/pack_citycode.py [输入文件] [输出文件] [坐标文件]
+
+修改citycode.json或citygeo.csv后需要重新运行该脚本。
+"""
+
+import csv
+import json
+import os
+import sys
+
+
+def load_geo(path):
+    """读取坐标文件，返回城市代码到(lat, lon)的映射，文件不存在时返回空映射"""
+    geo = {}
+    if not os.path.exists(path):
+        return geo
+    with open(path, encoding="utf-8") as f:
+        for row in csv.reader(f):
+            if not row or row[0].startswith("#"):
+                continue
+            code, lat, lon = row[0].strip(), float(row[1]), float(row[2])
+            if not (-90 <= lat <= 90 and -180 <= lon <= 180):
+                raise ValueError("坐标超出范围: %s" % ",".join(row))
+            geo[code] = (lat, lon)
+    return geo
+
+# 程序实际读取的字段，顺序即输出顺序；population和坐标为可选字段
+KEPT_FIELDS = ("id", "pid", "city_code", "city_name", "population", "lat", "lon")
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    src = sys.argv[1] if len(sys.argv) > 1 else os.path.join(root, "citycode.json")
+    dst = sys.argv[2] if len(sys.argv) > 2 else os.path.join(root, "citycode.min.json")
+    geo_path = sys.argv[3] if len(sys.argv) > 3 else os.path.join(root, "citygeo.csv")
+
+    with open(src, encoding="utf-8") as f:
+        cities = json.load(f)
+
+    geo = load_geo(geo_path)
+    for city in cities:
+        if city.get("city_code") in geo:
+            city["lat"], city["lon"] = geo[city["city_code"]]
+
+    packed = [{key: city[key] for key in KEPT_FIELDS if key in city} for city in cities]
+    data = json.dumps(packed, ensure_ascii=False, separators=(",", ":")).encode("utf-8")
+
+    with open(dst, "wb") as f:
+        f.write(data)
+
+    located = sum(1 for city in packed if "lat" in city)
+    print("%s: %d 条记录（%d 条带坐标）, %d -> %d 字节"
+          % (os.path.basename(dst), len(packed), located, os.path.getsize(src), len(data)))
+
+
+if __name__ == "__main__":
+    main()
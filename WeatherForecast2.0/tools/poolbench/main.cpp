@@ -0,0 +1,311 @@
+/**
+ * @file main.cpp
+ * @brief 天气数据对象池基准测试程序
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 用法：
+ *     poolbench [每个线程的对象数] [线程数] [队列深度]
+ *
+ * 用与LazyForecast、ForecastRecord大小相同的对象，分别测量使用RecordPool
+ * 和直接使用全局operator new时，多线程下每个对象的分配和释放耗时，
+ * 以及每千个对象调用全局operator new（即malloc）的次数。
+ *
+ * 负载：
+ *     local     每个线程每轮创建一批对象（相当于一轮刷新的城市数），再全部释放
+ *     pipeline  线程数个生产者创建对象，成批交给一个消费者线程释放；
+ *               对象池把内存块送回生产者，生产者稳定运行后几乎不再调用malloc。
+ *               队列深度是最多积压的批次数，默认为1（一轮刷新）；每个生产者
+ *               同时在途的对象超过RecordPool::kMaxFreeBlocks时，超出的部分
+ *               归还后交还系统，malloc次数随队列深度增加
+ *
+ * 每种组合输出一行"键=值"形式的结果：
+ *     workload      负载
+ *     record        对象类型和字节数
+ *     pool          是否使用对象池
+ *     ns_per_record 每个对象创建和释放的平均耗时（墙钟时间除以对象总数）
+ *     mallocs_per_k 每千个对象调用全局operator new的次数
+ */
+
+#include "forecastrecord.h"   // ForecastRecord的大小
+#include "lazyforecast.h"     // LazyForecast的大小
+#include "recordpool.h"       // 按线程缓存的对象内存
+
+#include <QCoreApplication>   // 应用程序核心功能
+#include <QElapsedTimer>      // 计时
+#include <QMutex>             // 生产者和消费者之间的队列
+#include <QQueue>             // 待释放的对象批次
+#include <QTextStream>        // 标准输出
+#include <QThread>            // CPU核心数
+#include <QWaitCondition>     // 队列满和空时等待
+
+#include <atomic>             // 全局operator new的调用计数
+#include <cstdlib>            // malloc和free
+#include <thread>             // 工作线程
+#include <vector>             // 线程列表
+
+// 默认每个线程创建的对象数
+static const int kDefaultRecords = 200000;
+
+// 每批对象数，与缓存的城市数上限一致
+static const int kBatchSize = 32;
+
+// 生产者和消费者之间默认最多积压的批次数
+static const int kDefaultQueueDepth = 1;
+
+// 全局operator new的调用次数
+static std::atomic<qint64> sMallocCount(0);
+
+void *operator new(size_t size)
+{
+    sMallocCount.fetch_add(1, std::memory_order_relaxed);
+    void *block = malloc(size ? size : 1);
+    if(!block)
+    {
+        throw std::bad_alloc();
+    }
+    return block;
+}
+
+void operator delete(void *block) noexcept
+{
+    free(block);
+}
+
+void operator delete(void *block, size_t) noexcept
+{
+    free(block);
+}
+
+/**
+ * @brief 使用对象池的测试对象
+ */
+template<size_t Size>
+struct PooledRecord
+{
+    char payload[Size];
+
+    static void *operator new(size_t size)
+    {
+        return RecordPool<PooledRecord>::allocate(size);
+    }
+
+    static void operator delete(void *block, size_t size)
+    {
+        RecordPool<PooledRecord>::release(block, size);
+    }
+};
+
+/**
+ * @brief 直接使用全局operator new的测试对象
+ */
+template<size_t Size>
+struct PlainRecord
+{
+    char payload[Size];
+};
+
+/**
+ * @brief 写入对象的首尾，使分配的内存真正被使用
+ */
+template<class Record>
+static Record *createRecord(int serial)
+{
+    Record *record = new Record;
+    record->payload[0] = static_cast<char>(serial);
+    record->payload[sizeof(record->payload) - 1] = static_cast<char>(serial >> 8);
+    return record;
+}
+
+/**
+ * @brief 一次测量的结果
+ */
+struct BenchResult
+{
+    double nsPerRecord;     // 每个对象的平均耗时
+    double mallocsPerK;     // 每千个对象的malloc次数
+};
+
+/**
+ * @brief local负载：每个线程批量创建并释放自己的对象
+ */
+template<class Record>
+static BenchResult runLocal(int records, int threads)
+{
+    qint64 mallocsBefore = sMallocCount.load();
+    QElapsedTimer timer;
+    timer.start();
+
+    std::vector<std::thread> workers;
+    for(int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([records]() {
+            Record *batch[kBatchSize];
+            for(int done = 0; done < records; done += kBatchSize)
+            {
+                for(int i = 0; i < kBatchSize; i++)
+                {
+                    batch[i] = createRecord<Record>(done + i);
+                }
+                for(int i = 0; i < kBatchSize; i++)
+                {
+                    delete batch[i];
+                }
+            }
+        });
+    }
+    for(std::thread &worker : workers)
+    {
+        worker.join();
+    }
+
+    qint64 total = static_cast<qint64>(records) * threads;
+    BenchResult result;
+    result.nsPerRecord = static_cast<double>(timer.nsecsElapsed()) / total;
+    result.mallocsPerK = (sMallocCount.load() - mallocsBefore) * 1000.0 / total;
+    return result;
+}
+
+/**
+ * @brief pipeline负载：生产者创建对象，一个消费者线程释放
+ *
+ * 队列本身的内存在计时前预留，不计入malloc次数。
+ */
+template<class Record>
+static BenchResult runPipeline(int records, int threads, int queueDepth)
+{
+    struct Batch
+    {
+        Record *records[kBatchSize];
+    };
+
+    QMutex mutex;
+    QWaitCondition changed;
+    QQueue<Batch> queue;
+    queue.reserve(queueDepth + threads);
+    int producing = threads;
+
+    qint64 mallocsBefore = sMallocCount.load();
+    QElapsedTimer timer;
+    timer.start();
+
+    std::vector<std::thread> producers;
+    for(int t = 0; t < threads; t++)
+    {
+        producers.emplace_back([&, records]() {
+            for(int done = 0; done < records; done += kBatchSize)
+            {
+                Batch batch;
+                for(int i = 0; i < kBatchSize; i++)
+                {
+                    batch.records[i] = createRecord<Record>(done + i);
+                }
+                QMutexLocker locker(&mutex);
+                while(queue.size() >= queueDepth)
+                {
+                    changed.wait(&mutex);
+                }
+                queue.enqueue(batch);
+                changed.wakeAll();
+            }
+            QMutexLocker locker(&mutex);
+            producing--;
+            changed.wakeAll();
+        });
+    }
+
+    // 消费者相当于界面线程，释放全部对象
+    std::thread consumer([&]() {
+        while(true)
+        {
+            Batch batch;
+            {
+                QMutexLocker locker(&mutex);
+                while(queue.isEmpty() && producing > 0)
+                {
+                    changed.wait(&mutex);
+                }
+                if(queue.isEmpty())
+                {
+                    return;
+                }
+                batch = queue.dequeue();
+                changed.wakeAll();
+            }
+            for(int i = 0; i < kBatchSize; i++)
+            {
+                delete batch.records[i];
+            }
+        }
+    });
+
+    for(std::thread &producer : producers)
+    {
+        producer.join();
+    }
+    consumer.join();
+
+    qint64 total = static_cast<qint64>(records) * threads;
+    BenchResult result;
+    result.nsPerRecord = static_cast<double>(timer.nsecsElapsed()) / total;
+    result.mallocsPerK = (sMallocCount.load() - mallocsBefore) * 1000.0 / total;
+    return result;
+}
+
+/**
+ * @brief 输出一行结果
+ */
+static void printResult(QTextStream &out, const char *workload, const char *record, size_t size,
+                        bool pooled, const BenchResult &result)
+{
+    out << "workload=" << workload
+        << " record=" << record << "/" << static_cast<qulonglong>(size)
+        << " pool=" << (pooled ? "on" : "off")
+        << " ns_per_record=" << QString::number(result.nsPerRecord, 'f', 1)
+        << " mallocs_per_k=" << QString::number(result.mallocsPerK, 'f', 1)
+        << "\n";
+    out.flush();
+}
+
+/**
+ * @brief 对一种对象大小运行全部负载，使用和不使用对象池各一次
+ */
+template<size_t Size>
+static void runAll(QTextStream &out, const char *name, int records, int threads, int queueDepth)
+{
+    printResult(out, "local", name, Size, false, runLocal<PlainRecord<Size>>(records, threads));
+    printResult(out, "local", name, Size, true, runLocal<PooledRecord<Size>>(records, threads));
+    printResult(out, "pipeline", name, Size, false,
+                runPipeline<PlainRecord<Size>>(records, threads, queueDepth));
+    printResult(out, "pipeline", name, Size, true,
+                runPipeline<PooledRecord<Size>>(records, threads, queueDepth));
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QTextStream out(stdout);
+
+    QStringList arguments = a.arguments();
+    int records = arguments.size() > 1 ? arguments.at(1).toInt() : kDefaultRecords;
+    if(records <= 0)
+    {
+        records = kDefaultRecords;
+    }
+    int threads = arguments.size() > 2 ? arguments.at(2).toInt() : QThread::idealThreadCount();
+    if(threads <= 0)
+    {
+        threads = qMax(1, QThread::idealThreadCount());
+    }
+    int queueDepth = arguments.size() > 3 ? arguments.at(3).toInt() : kDefaultQueueDepth;
+    if(queueDepth <= 0)
+    {
+        queueDepth = kDefaultQueueDepth;
+    }
+
+    out << "records_per_thread=" << records << " threads=" << threads
+        << " batch=" << kBatchSize << " queue_depth=" << queueDepth << "\n";
+    runAll<sizeof(LazyForecast)>(out, "LazyForecast", records, threads, queueDepth);
+    runAll<sizeof(ForecastRecord)>(out, "ForecastRecord", records, threads, queueDepth);
+    return 0;
+}
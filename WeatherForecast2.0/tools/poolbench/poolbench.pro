@@ -0,0 +1,31 @@
+# 天气数据对象池基准测试程序
+#
+# 比较LazyForecast和ForecastRecord大小的对象使用RecordPool和直接使用
+# 全局operator new时的分配耗时和malloc次数，分为两种负载：
+# - local：每个线程批量创建并释放自己的对象，对应后台线程的批量刷新
+# - pipeline：多个生产者线程创建对象，由一个消费者线程释放，对应后台解析、界面释放
+#
+# 构建和运行：
+#     cd tools/poolbench && qmake && make
+#     ./poolbench [每个线程的对象数] [线程数] [队列深度]
+#
+# 只依赖对象池头文件和天气数据类的头文件（用于取得对象大小），不依赖界面和网络模块。
+
+QT       += core
+QT       -= gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = poolbench
+
+SRC = ../..
+INCLUDEPATH += $$SRC
+
+SOURCES += \
+    main.cpp
+
+HEADERS += \
+    $$SRC/forecastrecord.h \
+    $$SRC/lazyforecast.h \
+    $$SRC/recordpool.h
@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+@file resource_report.py
+@brief 统计各资源文件打包进可执行文件后的体积
+
+按照rcc的规则估算每个资源在二进制中占用的字节数：
+使用zlib压缩，压缩节省的比例达到阈值时保存压缩数据，否则保存原始数据。
+同时列出内容完全相同的重复资源。
+
+用法：
+    python3 tools/resource_report.py [qrc文件...]
+
+默认统计项目中.pro文件引用的citycode.qrc和res.qrc。
+压缩级别和阈值应与Weather_Forecast.pro中的QMAKE_RESOURCE_FLAGS保持一致。
+"""
+
+import hashlib
+import os
+import sys
+import xml.etree.ElementTree as ET
+import zlib
+
+# 与QMAKE_RESOURCE_FLAGS中的-compress和-threshold保持一致
+DEFAULT_COMPRESS_LEVEL = 9
+DEFAULT_THRESHOLD = 20
+
+
+def packed_size(data, level, threshold):
+    """返回资源在rcc输出中的大小和是否被压缩"""
+    if level == 0 or not data:
+        return len(data), False
+    compressed = zlib.compress(data, level)
+    # rcc在压缩数据前额外保存4字节的原始长度
+    if (len(data) - len(compressed) - 4) * 100 >= threshold * len(data):
+        return len(compressed) + 4, True
+    return len(data), False
+
+
+def read_qrc(path):
+    """解析qrc文件，返回(资源路径, 磁盘文件, 压缩级别, 阈值)列表"""
+    base = os.path.dirname(os.path.abspath(path))
+    entries = []
+    for resource in ET.parse(path).getroot().iter("qresource"):
+        prefix = resource.get("prefix", "/").rstrip("/")
+        for node in resource.iter("file"):
+            name = node.get("alias", node.text)
+            level = int(node.get("compress", DEFAULT_COMPRESS_LEVEL))
+            threshold = int(node.get("threshold", DEFAULT_THRESHOLD))
+            entries.append((":%s/%s" % (prefix, name), os.path.join(base, node.text),
+                            level, threshold))
+    return entries
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    qrcs = sys.argv[1:] or [os.path.join(root, "citycode.qrc"), os.path.join(root, "res.qrc")]
+
+    rows = []
+    digests = {}
+    for qrc in qrcs:
+        for resource, path, level, threshold in read_qrc(qrc):
+            with open(path, "rb") as f:
+                data = f.read()
+            size, compressed = packed_size(data, level, threshold)
+            rows.append((resource, len(data), size, compressed))
+            digests.setdefault(hashlib.sha1(data).hexdigest(), []).append(resource)
+
+    rows.sort(key=lambda row: row[2], reverse=True)
+    print("%-48s %10s %10s  %s" % ("资源", "原始大小", "打包大小", "压缩"))
+    for resource, raw, size, compressed in rows:
+        print("%-48s %10d %10d  %s" % (resource, raw, size, "是" if compressed else "否"))
+    print("%-48s %10d %10d" % ("合计", sum(r[1] for r in rows), sum(r[2] for r in rows)))
+
+    duplicates = [names for names in digests.values() if len(names) > 1]
+    if duplicates:
+        print("\n内容重复的资源：")
+        for names in duplicates:
+            print("  " + ", ".join(names))
+
+
+if __name__ == "__main__":
+    main()
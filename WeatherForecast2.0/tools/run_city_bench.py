@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+@file run_city_bench.py
+@brief 在2.5k、100k、1M三种规模下运行城市索引基准测试
+
+用gen_city_dataset.py生成三种规模的合成城市数据，依次交给citybench
+读取并建立索引，每种规模重复若干次取中位数，最后输出汇总表格：
+读取耗时、建立索引耗时、索引的内存占用，以及名称查询、候选城市查询
+和未命中查询的平均耗时，以及空间索引的最近城市、最近5个城市和50千米
+半径查询的平均耗时（生成的数据带有合成坐标）。
+
+用法：
+    python3 tools/run_city_bench.py citybench可执行文件 [重复次数] [规模...]
+
+例如：
+    cd tools/citybench && qmake && make && cd ../..
+    python3 tools/run_city_bench.py tools/citybench/citybench
+    python3 tools/run_city_bench.py tools/citybench/citybench 5 2500 100000
+
+生成的数据放在系统临时目录中，已存在时直接复用。
+"""
+
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+
+DEFAULT_SIZES = (2500, 100000, 1000000)
+DEFAULT_REPEAT = 3
+
+# 汇总表格的列：(citybench输出的键, 表头)
+COLUMNS = (
+    ("read_ms", "读取ms"),
+    ("build_ms", "建索引ms"),
+    ("rss_kb", "索引内存KB"),
+    ("peak_rss_kb", "峰值内存KB"),
+    ("lookup_ns", "查询ns"),
+    ("candidates_ns", "候选ns"),
+    ("miss_ns", "未命中ns"),
+    ("hit_rate", "命中率"),
+    ("nearest_ns", "最近ns"),
+    ("nearest5_ns", "最近5个ns"),
+    ("radius_ns", "半径ns"),
+)
+
+
+def dataset(size):
+    """生成或复用指定规模的数据文件，返回路径"""
+    path = os.path.join(tempfile.gettempdir(), "weather_city_geo_%d.json" % size)
+    if not os.path.exists(path):
+        generator = os.path.join(os.path.dirname(os.path.abspath(__file__)), "gen_city_dataset.py")
+        subprocess.check_call([sys.executable, generator, str(size), path])
+    return path
+
+
+def run_once(bench, path):
+    """运行一次citybench，返回键到数值的映射"""
+    output = subprocess.check_output([bench, path], universal_newlines=True)
+    line = output.strip().splitlines()[-1]
+    return {key: float(value) for key, value in (item.split("=", 1) for item in line.split())}
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__)
+        sys.exit(1)
+
+    bench = os.path.abspath(sys.argv[1])
+    repeat = int(sys.argv[2]) if len(sys.argv) > 2 else DEFAULT_REPEAT
+    sizes = [int(arg) for arg in sys.argv[3:]] or list(DEFAULT_SIZES)
+
+    # 先生成全部数据，生成过程的输出不夹在表格中间
+    paths = [dataset(size) for size in sizes]
+
+    print("%-10s %-10s" % ("规模", "记录数") + "".join("%-12s" % title for _, title in COLUMNS))
+    for size, path in zip(sizes, paths):
+        runs = [run_once(bench, path) for _ in range(repeat)]
+        row = "%-10d %-10d" % (size, runs[0]["records"])
+        for key, _ in COLUMNS:
+            row += "%-12s" % ("%.3f" % statistics.median(run[key] for run in runs)
+                              if key == "hit_rate"
+                              else "%.0f" % statistics.median(run[key] for run in runs))
+        print(row)
+
+
+if __name__ == "__main__":
+    main()
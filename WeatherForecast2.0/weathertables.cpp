@@ -0,0 +1,204 @@
+/**
+ * @file weathertables.cpp
+ * @brief 天气类型与空气质量样式查找表的实现文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 查找表以constexpr数组的形式存放在只读数据段中，程序启动时不做任何初始化。
+ * 新增表项时必须保持按UTF-8字节序排列，否则static_assert会在编译期报错。
+ */
+
+#include "weathertables.h"    // 查找表头文件
+
+#include <cstring>            // strlen
+
+namespace {
+
+/**
+ * @brief 查找表项：UTF-8名称和对应的值
+ */
+struct TableEntry
+{
+    const char *name;   // UTF-8编码的名称
+    const char *value;  // 图标路径或CSS样式
+};
+
+/**
+ * @brief 天气类型查找表，按名称的UTF-8字节序排列
+ */
+constexpr TableEntry kWeatherTypes[] = {
+    { "中到大雨", ":/type/ZhongDaoDaYu.png" },
+    { "中到大雪", ":/type/ZhongDaoDaXue.png" },
+    { "中雨", ":/type/ZhongYu.png" },
+    { "中雪", ":/type/ZhongXue.png" },
+    { "冻雨", ":/type/DongYu.png" },
+    { "多云", ":/type/DuoYun.png" },
+    { "多云转阴", ":/type/Yin.png" },
+    { "大到暴雪", ":/type/DaDaoBaoXue.png" },
+    { "大暴雨", ":/type/DaBaoYu.png" },
+    { "大暴雨到特大暴雨", ":/type/DaBaoYuDaoTeDaBaoYu.png" },
+    { "大雨", ":/type/DaYu.png" },
+    { "大雪", ":/type/DaXue.png" },
+    { "小到中雨", ":/type/XiaoDaoZhongYu.png" },
+    { "小到中雪", ":/type/XiaoDaoZhongXue.png" },
+    { "小雨", ":/type/XiaoYu.png" },
+    { "小雪", ":/type/XiaoXue.png" },
+    { "强沙尘暴", ":/type/QiangShaChenBao.png" },
+    { "扬沙", ":/type/YangSha.png" },
+    { "晴", ":/type/Qing.png" },
+    { "暴雨", ":/type/BaoYu.png" },
+    { "暴雨到大暴雨", ":/type/BaoYuDaoDaBaoYu.png" },
+    { "暴雪", ":/type/BaoXue.png" },
+    { "沙尘暴", ":/type/ShaChenBao.png" },
+    { "浮沉", ":/type/FuChen.png" },
+    { "特大暴雨", ":/type/TeDaBaoYu.png" },
+    { "阴", ":/type/Yin.png" },
+    { "阵雨", ":/type/ZhenYu.png" },
+    { "阵雪", ":/type/ZhenXue.png" },
+    { "雨", ":/type/Yu.png" },
+    { "雨夹雪", ":/type/YuJiaXue.png" },
+    { "雪", ":/type/Xue.png" },
+    { "雷阵雨", ":/type/LeiZhenYu.png" },
+    { "雷阵雨伴有冰雹", ":/type/LeiZhenYuBanYouBingBao.png" },
+    { "雾", ":/type/Wu.png" },
+    { "霾", ":/type/Mai.png" },
+    // 回退表项，不参与查找，下标即kUnknownWeatherType
+    { "undefined", ":/type/undefined.png" },
+};
+
+/**
+ * @brief 空气质量样式查找表，按名称的UTF-8字节序排列
+ */
+constexpr TableEntry kAirQualityStyles[] = {
+    { "严重", "background: rgba(102, 0, 0, 0.4);border: 1px solid rgba(102, 0, 0, 0.5);backdrop-filter: blur(6px);border-radius:7px;color:rgba(255,255,255,0.95)" },
+    { "中度", "background: rgba(255, 17, 17, 0.3);border: 1px solid rgba(255, 17, 17, 0.4);backdrop-filter: blur(6px);border-radius:7px;color:rgba(255,255,255,0.95)" },
+    { "优", "background: rgba(85, 255, 127, 0.25);border: 1px solid rgba(85, 255, 127, 0.3);backdrop-filter: blur(6px);border-radius:7px;color:rgba(255,255,255,0.95)" },
+    { "良", "background: rgba(255, 170, 127, 0.25);border: 1px solid rgba(255, 170, 127, 0.3);backdrop-filter: blur(6px);border-radius:7px;color:rgba(255,255,255,0.95)" },
+    { "轻度", "background: rgba(255, 199, 199, 0.25);border: 1px solid rgba(255, 199, 199, 0.3);backdrop-filter: blur(6px);border-radius:7px;color:rgba(255,255,255,0.95)" },
+    { "重度", "background: rgba(153, 0, 0, 0.35);border: 1px solid rgba(153, 0, 0, 0.45);backdrop-filter: blur(6px);border-radius:7px;color:rgba(255,255,255,0.95)" },
+    // 回退表项，用于未知的空气质量等级
+    { "", "background: rgba(128, 128, 128, 0.25);border: 1px solid rgba(128, 128, 128, 0.3);backdrop-filter: blur(6px);border-radius:7px;color:rgba(255,255,255,0.95)" },
+};
+
+// 可查找的表项数量（不含末尾的回退表项）
+constexpr int kWeatherTypeCount = sizeof(kWeatherTypes) / sizeof(kWeatherTypes[0]) - 1;
+constexpr int kAirQualityCount = sizeof(kAirQualityStyles) / sizeof(kAirQualityStyles[0]) - 1;
+
+/**
+ * @brief 编译期按字节比较两个UTF-8字符串
+ */
+constexpr int compareBytes(const char *a, const char *b)
+{
+    return *a != *b
+            ? (static_cast<unsigned char>(*a) < static_cast<unsigned char>(*b) ? -1 : 1)
+            : (*a == '\0' ? 0 : compareBytes(a + 1, b + 1));
+}
+
+/**
+ * @brief 编译期检查表项是否严格按名称升序排列
+ */
+constexpr bool isSorted(const TableEntry *table, int count)
+{
+    return count < 2
+            || (compareBytes(table[0].name, table[1].name) < 0 && isSorted(table + 1, count - 1));
+}
+
+static_assert(isSorted(kWeatherTypes, kWeatherTypeCount), "kWeatherTypes必须按UTF-8字节序排列");
+static_assert(isSorted(kAirQualityStyles, kAirQualityCount), "kAirQualityStyles必须按UTF-8字节序排列");
+static_assert(kWeatherTypeCount < 255 && kAirQualityCount < 255, "ID类型为quint8");
+
+/**
+ * @brief 在有序表中二分查找名称
+ * @param table 有序表
+ * @param count 表项数量
+ * @param data 要查找的UTF-8名称
+ * @param size 名称字节数
+ * @return 找到时返回下标，否则返回count（即回退表项的下标）
+ */
+int findEntry(const TableEntry *table, int count, const char *data, int size)
+{
+    int low = 0;
+    int high = count;
+    while(low < high)
+    {
+        int middle = (low + high) / 2;
+        const char *name = table[middle].name;
+        int nameSize = static_cast<int>(strlen(name));
+        int result = memcmp(name, data, static_cast<size_t>(qMin(nameSize, size)));
+        if(result == 0)
+        {
+            result = nameSize - size;
+        }
+        if(result == 0)
+        {
+            return middle;
+        }
+        if(result < 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return count;
+}
+
+// "转"字的UTF-8编码，用于处理"晴转多云"这类天气类型
+const char kTransitionUtf8[] = "转";
+const int kTransitionSize = sizeof(kTransitionUtf8) - 1;
+
+} // namespace
+
+const WeatherTypeId WeatherTables::kUnknownWeatherType = kWeatherTypeCount;
+const AirQualityId WeatherTables::kUnknownAirQuality = kAirQualityCount;
+
+WeatherTypeId WeatherTables::weatherTypeFromName(const QString &name)
+{
+    QByteArray utf8 = name.toUtf8();
+    return weatherTypeFromUtf8(utf8.constData(), utf8.size());
+}
+
+WeatherTypeId WeatherTables::weatherTypeFromUtf8(const char *data, int size)
+{
+    // 先按完整名称查找，表中包含"多云转阴"这类完整的转换天气
+    int index = findEntry(kWeatherTypes, kWeatherTypeCount, data, size);
+    if(index != kWeatherTypeCount)
+    {
+        return static_cast<WeatherTypeId>(index);
+    }
+
+    // 含有"转"字时，取"转"字后面的天气类型
+    for(int i = 0; i + kTransitionSize <= size; i++)
+    {
+        if(memcmp(data + i, kTransitionUtf8, kTransitionSize) == 0)
+        {
+            int offset = i + kTransitionSize;
+            index = findEntry(kWeatherTypes, kWeatherTypeCount, data + offset, size - offset);
+            break;
+        }
+    }
+    return static_cast<WeatherTypeId>(index);
+}
+
+const char *WeatherTables::weatherTypeIcon(WeatherTypeId id)
+{
+    return kWeatherTypes[id < kWeatherTypeCount ? id : kWeatherTypeCount].value;
+}
+
+AirQualityId WeatherTables::airQualityFromName(const QString &name)
+{
+    QByteArray utf8 = name.toUtf8();
+    return airQualityFromUtf8(utf8.constData(), utf8.size());
+}
+
+AirQualityId WeatherTables::airQualityFromUtf8(const char *data, int size)
+{
+    return static_cast<AirQualityId>(findEntry(kAirQualityStyles, kAirQualityCount, data, size));
+}
+
+const char *WeatherTables::airQualityStyle(AirQualityId id)
+{
+    return kAirQualityStyles[id < kAirQualityCount ? id : kAirQualityCount].value;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file weathertables.h
+ * @brief 天气类型与空气质量样式查找表的头文件
+ * @author Weather Forecast Team
+ * @date 2025
+ *
+ * 该文件定义了WeatherTables类，提供编译期生成的只读查找表：
+ * - 天气类型名称 → 天气类型ID → 图标资源路径
+ * - 空气质量等级名称 → 空气质量ID → CSS样式
+ *
+ * 查找表按UTF-8字节序排序，在编译期校验有序性，由所有Widget实例共享。
+ * 名称只在解析数据时查找一次并转换为ID，界面更新时按ID直接索引数组。
+ */
+
+#ifndef WEATHERTABLES_H
+#define WEATHERTABLES_H
+
+#include <QString>      // Qt字符串类
+#include <QtGlobal>     // quint8等基本类型
+
+/**
+ * @brief 天气类型ID
+ *
+ * 取值为查找表中的下标，WeatherTables::kUnknownWeatherType表示未知天气类型。
+ */
+typedef quint8 WeatherTypeId;
+
+/**
+ * @brief 空气质量等级ID
+ *
+ * 取值为查找表中的下标，WeatherTables::kUnknownAirQuality表示未知等级。
+ */
+typedef quint8 AirQualityId;
+
+/**
+ * @class WeatherTables
+ * @brief 天气类型与空气质量的编译期查找表
+ */
+class WeatherTables
+{
+public:
+    /**
+     * @brief 未知天气类型的ID，对应编译期确定的回退图标
+     */
+    static const WeatherTypeId kUnknownWeatherType;
+
+    /**
+     * @brief 未知空气质量等级的ID，对应编译期确定的默认样式
+     */
+    static const AirQualityId kUnknownAirQuality;
+
+    /**
+     * @brief 根据天气类型名称获取ID
+     * @param name 天气类型名称，如"晴"、"多云转阴"、"晴转多云"
+     * @return 天气类型ID
+     *
+     * 先按完整名称查找；找不到且名称中含有"转"时，按"转"后面的天气类型查找。
+     */
+    static WeatherTypeId weatherTypeFromName(const QString &name);
+
+    /**
+     * @brief 根据UTF-8编码的天气类型名称获取ID
+     * @param data UTF-8数据
+     * @param size 字节数
+     * @return 天气类型ID
+     *
+     * 可以直接在网络数据上查找，无需先转换为QString。
+     */
+    static WeatherTypeId weatherTypeFromUtf8(const char *data, int size);
+
+    /**
+     * @brief 获取天气类型对应的图标资源路径
+     * @param id 天气类型ID，越界时返回回退图标
+     */
+    static const char *weatherTypeIcon(WeatherTypeId id);
+
+    /**
+     * @brief 根据空气质量等级名称获取ID
+     * @param name 空气质量等级名称，如"优"、"良"、"轻度"
+     */
+    static AirQualityId airQualityFromName(const QString &name);
+
+    /**
+     * @brief 根据UTF-8编码的空气质量等级名称获取ID
+     * @param data UTF-8数据
+     * @param size 字节数
+     */
+    static AirQualityId airQualityFromUtf8(const char *data, int size);
+
+    /**
+     * @brief 获取空气质量等级对应的CSS样式
+     * @param id 空气质量等级ID，越界时返回默认样式
+     */
+    static const char *airQualityStyle(AirQualityId id);
+};
+
+#endif // WEATHERTABLES_H
@@ -15,6 +15,8 @@
 
 #include "widget.h"        // 主窗口类头文件
 #include "ui_widget.h"     // UI界面头文件
+#include "weathertables.h" // 天气类型与空气质量查找表
+#include "forecastdate.h"  // 日期推算和格式化
 
 // Qt事件和界面相关头文件
 #include <QMouseEvent>      // 鼠标事件处理
@@ -22,13 +24,36 @@
 #include <QMessageBox>      // 消息框组件
 #include <QPainter>         // 绘图组件
 
-// Qt JSON数据处理相关头文件
-#include <QJsonDocument>    // JSON文档解析
-#include <QJsonObject>      // JSON对象操作
-#include <QJsonArray>       // JSON数组操作
+// 其他Qt头文件
 #include <QRegularExpression> // 正则表达式，用于输入验证
-#include <QSettings>          // 配置文件读取
 #include <QCoreApplication>   // 应用程序路径获取
+#include <QCompleter>         // 搜索框自动补全
+#include <QAbstractItemView>  // 自动补全弹出列表
+#include <QSet>               // 补全候选去重
+#include <QStandardPaths>     // 搜索历史文件路径
+#include <QtConcurrent>       // 后台补全查询
+#include <QTimer>             // 定时刷新
+
+// 网络请求的自定义属性：请求的城市代码、是否为后台预取，以及请求使用的API版本
+static const QNetworkRequest::Attribute kCityCodeAttribute = QNetworkRequest::User;
+static const QNetworkRequest::Attribute kPrefetchAttribute =
+        static_cast<QNetworkRequest::Attribute>(QNetworkRequest::User + 1);
+static const QNetworkRequest::Attribute kApiVersionAttribute =
+        static_cast<QNetworkRequest::Attribute>(QNetworkRequest::User + 2);
+
+// 网络请求的自定义属性：是否为只请求当天实况的分级刷新
+static const QNetworkRequest::Attribute kCurrentOnlyAttribute =
+        static_cast<QNetworkRequest::Attribute>(QNetworkRequest::User + 3);
+
+// 启动时预取天气数据的常用城市数量
+static const int kPrefetchCityCount = 3;
+
+// 自动补全列表中城市索引和历史记录各自最多提供的候选数量
+static const int kSuggestionCount = 8;
+
+// 补全候选携带的数据：填入输入框的城市名称和对应的城市代码
+static const int kSuggestionNameRole = Qt::UserRole;
+static const int kSuggestionCodeRole = Qt::UserRole + 1;
 
 /**
  * @brief Widget类构造函数
@@ -40,12 +65,27 @@
  * 3. 右键菜单的创建
  * 4. 网络管理器的初始化
  * 5. 控件列表的初始化
- * 6. 天气类型图标映射的建立
- * 7. 事件过滤器的安装
+ * 6. 事件过滤器的安装
+ * 7. 根据启动参数发起首个天气请求
+ * 
+ * 天气类型图标和空气质量样式使用WeatherTables中的编译期查找表，
+ * 构造时无需再逐项填充映射表。
  */
-Widget::Widget(QWidget *parent)
+Widget::Widget(const StartupOptions &options, QWidget *parent)
     : QWidget(parent)
+    , mForecast(new ForecastRecord)
     , ui(new Ui::Widget)
+    , mCityIndex(nullptr)
+    , mOffline(options.offline)
+    , mForecastTimer(nullptr)
+    , mCurrentTimer(nullptr)
+    , mAlternatesMenu(nullptr)
+    , mSearchHistory(nullptr)
+    , mSearchDispatcher(nullptr)
+    , mSuggestionCompleter(nullptr)
+    , mSuggestionModel(nullptr)
+    , mSuggestionGeneration(0)
+    , mForecastStore(nullptr)
 {
     // 初始化UI界面，加载.ui文件中定义的界面布局
     ui->setupUi(this);
@@ -79,26 +119,56 @@ Widget::Widget(QWidget *parent)
     // 加载配置文件中的API密钥等设置
     loadConfig();
     
+    // ========== 城市索引 ==========
+    // 在后台线程加载内置城市数据和别名，并叠加可执行文件同目录下的增量文件，
+    // 增量文件被修改后自动重新建立索引
+    mCityIndex = new CityIndexManager(":/citycode.json", ":/cityalias.csv",
+                                      QCoreApplication::applicationDirPath() + "/citycode.delta.json",
+                                      this);
+
+    // ========== 天气数据快照 ==========
+    // 解析完成的快照按城市发布，字段有变化时通过forecastChanged通知其他使用者
+    mForecastStore = new ForecastStore(this);
+    
     // ========== 网络管理器初始化 ==========
     // 创建网络访问管理器，用于处理HTTP请求，生命周期跟随当前对象
     manager = new QNetworkAccessManager(this);
 
-    // 从配置文件构建天气API的URL
-    // 使用天气API服务获取实时天气数据和预报信息
-    strUrl = getApiUrl();
-    QUrl urlTianQi(strUrl);
-
-    // 创建网络请求对象，设置请求的目标URL
-    QNetworkRequest res(urlTianQi);
-
-    // 发起GET请求获取默认城市的天气数据
-    // reply对象用于接收服务器响应
-    reply = manager->get(res);
-
     // 连接网络管理器的finished信号到数据处理槽函数
     // 当网络请求完成时，自动调用readHttpReply函数处理返回的数据
     connect(manager, &QNetworkAccessManager::finished, this, &Widget::readHttpReply);
 
+    // ========== 定时刷新 ==========
+    // 完整预报和当天实况分别计时，间隔由配置决定，配置热加载后重新设置
+    mForecastTimer = new QTimer(this);
+    mCurrentTimer = new QTimer(this);
+    connect(mForecastTimer, &QTimer::timeout, this, &Widget::onForecastRefresh);
+    connect(mCurrentTimer, &QTimer::timeout, this, &Widget::onCurrentRefresh);
+    applyRefreshConfig(*mConfigManager->snapshot());
+
+    // ========== 搜索历史 ==========
+    // 历史记录在后台线程加载，加载完成后预取常用城市
+    QString historyPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+            + "/history.dat";
+    mSearchHistory = new SearchHistory(historyPath, this);
+    connect(mSearchHistory, &SearchHistory::loaded, this, &Widget::onHistoryLoaded);
+    mSearchHistory->loadAsync();
+
+    // ========== 实时搜索 ==========
+    // 输入法组字期间不查询，输入稳定后才在后台线程查询补全候选，过期的结果直接丢弃。
+    // 补全列表只挂在输入框上而不通过setCompleter关联，避免每次按键都触发补全过滤
+    mSuggestionModel = new QStandardItemModel(this);
+    mSuggestionCompleter = new QCompleter(mSuggestionModel, this);
+    mSuggestionCompleter->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    mSuggestionCompleter->setWidget(ui->lineEditCity);
+    connect(mSuggestionCompleter, QOverload<const QModelIndex &>::of(&QCompleter::activated),
+            this, &Widget::onSuggestionActivated);
+
+    mSearchDispatcher = new SearchDispatcher(ui->lineEditCity, this);
+    connect(mSearchDispatcher, &SearchDispatcher::queryReady, this, &Widget::onSearchQuery);
+    connect(&mSuggestionWatcher, &QFutureWatcher<QVector<CityCandidate>>::finished,
+            this, &Widget::onSuggestionsReady);
+
     // ========== UI控件列表初始化 ==========
     // 初始化各种天气信息显示控件的列表，便于批量操作和数据更新
     
@@ -137,55 +207,12 @@ Widget::Widget(QWidget *parent)
           <<ui->labelFL2<<ui->labelFL3
          <<ui->labelFL4<<ui->labelFL5;
 
-    //根据keys,设置icon的路径
-    mTypeMap.insert("暴雪",":/type/BaoXue.png");
-    mTypeMap.insert("暴雨",":/type/BaoYu.png");
-    mTypeMap.insert("暴雨到大暴雨",":/type/BaoYuDaoDaBaoYu.png");
-    mTypeMap.insert("大暴雨",":/type/DaBaoYu.png");
-    mTypeMap.insert("大暴雨到特大暴雨",":/type/DaBaoYuDaoTeDaBaoYu.png");
-    mTypeMap.insert("大到暴雪",":/type/DaDaoBaoXue.png");
-    mTypeMap.insert("大雪",":/type/DaXue.png");
-    mTypeMap.insert("大雨",":/type/DaYu.png");
-    mTypeMap.insert("冻雨",":/type/DongYu.png");
-    mTypeMap.insert("多云",":/type/DuoYun.png");
-    mTypeMap.insert("浮沉",":/type/FuChen.png");
-    mTypeMap.insert("雷阵雨",":/type/LeiZhenYu.png");
-    mTypeMap.insert("雷阵雨伴有冰雹",":/type/LeiZhenYuBanYouBingBao.png");
-    mTypeMap.insert("霾",":/type/Mai.png");
-    mTypeMap.insert("强沙尘暴",":/type/QiangShaChenBao.png");
-    mTypeMap.insert("晴",":/type/Qing.png");
-    mTypeMap.insert("沙尘暴",":/type/ShaChenBao.png");
-    mTypeMap.insert("特大暴雨",":/type/TeDaBaoYu.png");
-    mTypeMap.insert("undefined",":/type/undefined.png");
-    mTypeMap.insert("雾",":/type/Wu.png");
-    mTypeMap.insert("小到中雪",":/type/XiaoDaoZhongXue.png");
-    mTypeMap.insert("小到中雨",":/type/XiaoDaoZhongYu.png");
-    mTypeMap.insert("小雪",":/type/XiaoXue.png");
-    mTypeMap.insert("小雨",":/type/XiaoYu.png");
-    mTypeMap.insert("雪",":/type/Xue.png");
-    mTypeMap.insert("扬沙",":/type/YangSha.png");
-    mTypeMap.insert("阴",":/type/Yin.png");
-    mTypeMap.insert("多云转阴",":/type/Yin.png");
-    mTypeMap.insert("雨",":/type/Yu.png");
-    mTypeMap.insert("雨夹雪",":/type/YuJiaXue.png");
-    mTypeMap.insert("阵雪",":/type/ZhenXue.png");
-    mTypeMap.insert("阵雨",":/type/ZhenYu.png");
-    mTypeMap.insert("中到大雪",":/type/ZhongDaoDaXue.png");
-    mTypeMap.insert("中到大雨",":/type/ZhongDaoDaYu.png");
-    mTypeMap.insert("中雪",":/type/ZhongXue.png");
-    mTypeMap.insert("中雨",":/type/ZhongYu.png");
-
-    // ========== 空气质量样式映射表初始化 ==========
-    // 初始化不同空气质量等级对应的CSS样式，统一管理样式设置
-    mAirQualityStyleMap.insert("优", "background: rgba(85, 255, 127, 0.25);border: 1px solid rgba(85, 255, 127, 0.3);backdrop-filter: blur(6px);border-radius:7px;color:rgba(255,255,255,0.95)");
-    mAirQualityStyleMap.insert("良", "background: rgba(255, 170, 127, 0.25);border: 1px solid rgba(255, 170, 127, 0.3);backdrop-filter: blur(6px);border-radius:7px;color:rgba(255,255,255,0.95)");
-    mAirQualityStyleMap.insert("轻度", "background: rgba(255, 199, 199, 0.25);border: 1px solid rgba(255, 199, 199, 0.3);backdrop-filter: blur(6px);border-radius:7px;color:rgba(255,255,255,0.95)");
-    mAirQualityStyleMap.insert("中度", "background: rgba(255, 17, 17, 0.3);border: 1px solid rgba(255, 17, 17, 0.4);backdrop-filter: blur(6px);border-radius:7px;color:rgba(255,255,255,0.95)");
-    mAirQualityStyleMap.insert("重度", "background: rgba(153, 0, 0, 0.35);border: 1px solid rgba(153, 0, 0, 0.45);backdrop-filter: blur(6px);border-radius:7px;color:rgba(255,255,255,0.95)");
-    mAirQualityStyleMap.insert("严重", "background: rgba(102, 0, 0, 0.4);border: 1px solid rgba(102, 0, 0, 0.5);backdrop-filter: blur(6px);border-radius:7px;color:rgba(255,255,255,0.95)");
-
     ui->widget0404->installEventFilter(this);
     ui->widget0405->installEventFilter(this);
+
+    // ========== 首个天气请求 ==========
+    // 启动参数指定了城市时直接请求该城市，省去一次默认城市的往返
+    applyStartupOptions(options, true);
 }
 /*
   QNetworkAccessManager *manager = new QNetworkAccessManager(this);
@@ -201,6 +228,9 @@ Widget::Widget(QWidget *parent)
  */
 Widget::~Widget()
 {
+    // 后台补全查询使用城市索引管理器，等待全部查询（包括已被新输入替换、
+    // 仍在等待首次建立索引的查询）结束后再销毁子对象
+    mSuggestionLookups.waitForFinished();
     delete ui;
 }
 
@@ -273,27 +303,311 @@ void Widget::loadConfig()
     // 获取配置文件路径（与可执行文件同目录）
     QString configPath = QCoreApplication::applicationDirPath() + "/config.ini";
     
-    // 创建QSettings对象读取INI格式配置文件
-    QSettings settings(configPath, QSettings::IniFormat);
-    
-    // 读取API配置信息，如果配置文件不存在则使用默认值
-    settings.beginGroup("API");
-    mApiAppId = settings.value("appid", "29132936").toString();
-    mApiAppSecret = settings.value("appsecret", "JV3FYmaV").toString();
-    mApiBaseUrl = settings.value("base_url", "http://gfeljm.tianqiapi.com/api").toString();
-    mApiVersion = settings.value("version", "v9").toString();
-    settings.endGroup();
+    // 创建配置管理器，同步读取一次配置并开始监视文件修改
+    mConfigManager = new ConfigManager(configPath, this);
+    mApiVersion = mConfigManager->snapshot()->apiVersion;
+    connect(mConfigManager, &ConfigManager::configChanged, this, &Widget::onConfigChanged);
+}
+
+QString Widget::getApiUrl(const QString &cityCode)
+{
+    // 每次构建URL时读取最新的配置快照，热加载后的配置立即生效
+    return mConfigManager->snapshot()->apiUrl(cityCode);
+}
+
+void Widget::onConfigChanged(AppConfigSnapshot config)
+{
+    qDebug() << "配置已重新加载:" << config->apiBaseUrl << config->apiVersion;
+
+    // 不同API版本的响应格式不同，旧版本的缓存数据无法按新格式解析
+    if(config->apiVersion != mApiVersion)
+    {
+        mForecastCache.clear();
+        mPendingForecasts.clear();
+        mForecastStore->clear();
+        mApiVersion = config->apiVersion;
+    }
+
+    // 使用新配置重新请求当前城市的天气，不使用旧配置获取的缓存
+    applyRefreshConfig(*config);
+    requestWeather(mCurrentCityCode, false);
+}
+
+void Widget::applyRefreshConfig(const AppConfig &config)
+{
+    mForecastTimer->stop();
+    mCurrentTimer->stop();
+
+    // 离线模式下不发起任何网络请求，也就不需要定时刷新
+    if(mOffline || config.refreshMode == "off")
+    {
+        return;
+    }
+    mForecastTimer->start(config.refreshForecastSeconds * 1000);
+    if(config.refreshMode == "tiered")
+    {
+        mCurrentTimer->start(config.refreshCurrentSeconds * 1000);
+    }
+}
+
+void Widget::onForecastRefresh()
+{
+    // 刚刚请求的完整预报包含当天实况，当天实况的下一次刷新从现在重新计时
+    if(mCurrentTimer->isActive())
+    {
+        mCurrentTimer->start();
+    }
+    requestWeather(mCurrentCityCode, false);
+}
+
+void Widget::onCurrentRefresh()
+{
+    requestCurrentConditions();
+}
+
+void Widget::requestCurrentConditions()
+{
+    if(mOffline)
+    {
+        return;
+    }
+
+    // 当天实况的响应只有完整预报的一小部分，按配置中的轻量版本请求
+    AppConfigSnapshot config = mConfigManager->snapshot();
+    QNetworkRequest request((QUrl(config->apiUrl(mCurrentCityCode, config->currentVersion))));
+    request.setAttribute(kCityCodeAttribute, mCurrentCityCode);
+    request.setAttribute(kCurrentOnlyAttribute, true);
+    request.setAttribute(kApiVersionAttribute, config->currentVersion);
+    manager->get(request);
+}
+
+void Widget::onHistoryLoaded()
+{
+    prefetchTopCities();
+}
+
+void Widget::onSearchQuery(const QString &text, quint64 generation)
+{
+    if(text.isEmpty())
+    {
+        mSuggestionCompleter->popup()->hide();
+        return;
+    }
+
+    // 查询在后台线程进行，首次建立城市索引尚未完成时也不阻塞输入；
+    // 上一次查询尚未完成时直接替换，其结果不会再被处理
+    mSuggestionGeneration = generation;
+    mSuggestionText = text;
+    CityIndexManager *cityIndex = mCityIndex;
+    QFuture<QVector<CityCandidate>> lookup = QtConcurrent::run([cityIndex, text]() {
+        return cityIndex->snapshot()->completeCityName(text, kSuggestionCount);
+    });
+    mSuggestionWatcher.setFuture(lookup);
+
+    // 被替换的查询仍在使用城市索引管理器，全部记录下来，析构时一并等待；
+    // 已结束的查询随时丢弃，记录的数量不超过同时运行的查询数
+    const QList<QFuture<QVector<CityCandidate>>> lookups = mSuggestionLookups.futures();
+    mSuggestionLookups.clearFutures();
+    for(const QFuture<QVector<CityCandidate>> &pending : lookups)
+    {
+        if(!pending.isFinished())
+        {
+            mSuggestionLookups.addFuture(pending);
+        }
+    }
+    mSuggestionLookups.addFuture(lookup);
+}
+
+void Widget::onSuggestionsReady()
+{
+    // 查询期间用户继续输入、开始组字或已经按下回车时丢弃结果
+    if(!mSearchDispatcher->isCurrent(mSuggestionGeneration))
+    {
+        return;
+    }
+
+    // 先列出以输入开头的历史记录，再列出城市索引的补全结果，同一城市只出现一次
+    mSuggestionModel->clear();
+    QSet<QString> codes;
+    int historyCount = 0;
+    const QStringList historyNames = mSearchHistory->names();
+    for(const QString &name : historyNames)
+    {
+        if(historyCount >= kSuggestionCount || !name.startsWith(mSuggestionText, Qt::CaseInsensitive))
+        {
+            continue;
+        }
+        QString code = mSearchHistory->recall(name);
+        if(codes.contains(code))
+        {
+            continue;
+        }
+        QStandardItem *item = new QStandardItem(name);
+        item->setData(name, kSuggestionNameRole);
+        item->setData(code, kSuggestionCodeRole);
+        mSuggestionModel->appendRow(item);
+        codes.insert(code);
+        historyCount++;
+    }
+
+    const QVector<CityCandidate> cities = mSuggestionWatcher.result();
+    for(const CityCandidate &city : cities)
+    {
+        if(codes.contains(city.code))
+        {
+            continue;
+        }
+        QStandardItem *item = new QStandardItem(city.displayName());
+        item->setData(city.name, kSuggestionNameRole);
+        item->setData(city.code, kSuggestionCodeRole);
+        mSuggestionModel->appendRow(item);
+        codes.insert(city.code);
+    }
+
+    if(mSuggestionModel->rowCount() == 0 || !ui->lineEditCity->hasFocus())
+    {
+        mSuggestionCompleter->popup()->hide();
+        return;
+    }
+    mSuggestionCompleter->complete();
 }
 
-QString Widget::getApiUrl()
+void Widget::onSuggestionActivated(const QModelIndex &index)
 {
-    // 根据配置文件中的参数构建完整的API请求URL
-    QString url = QString("%1?unescape=1&version=%2&appid=%3&appsecret=%4")
-                    .arg(mApiBaseUrl)
-                    .arg(mApiVersion)
-                    .arg(mApiAppId)
-                    .arg(mApiAppSecret);
-    return url;
+    QString name = index.data(kSuggestionNameRole).toString();
+    QString code = index.data(kSuggestionCodeRole).toString();
+    if(code.isEmpty())
+    {
+        return;
+    }
+
+    // 填入输入框的文字不是用户输入，不再触发补全查询
+    mSearchDispatcher->cancel();
+    ui->lineEditCity->setText(name);
+    requestWeather(code);
+    recordSearch(name, code);
+}
+
+void Widget::requestWeather(const QString &cityCode, bool useCache)
+{
+    // 记录当前城市，热加载配置后使用同一城市重新请求
+    mCurrentCityCode = cityCode;
+
+    // 缓存中有数据时直接显示，离线模式下不检查缓存是否过期
+    QByteArray cachedData;
+    int maxAge = mOffline ? -1 : mConfigManager->snapshot()->cacheTtlSeconds;
+    if(useCache && mForecastCache.lookup(cityCode, maxAge, &cachedData))
+    {
+        // 预取的响应在写入缓存时只扫描过，首次显示时才解码和发布
+        QSharedPointer<LazyForecast> pending = mPendingForecasts.take(cityCode);
+        if(pending)
+        {
+            publishForecast(cityCode, pending);
+            return;
+        }
+
+        // 显示过的响应已发布为快照，快照仍在时直接显示，不再解析
+        ForecastSnapshot forecast = mForecastStore->snapshot(cityCode);
+        if(forecast)
+        {
+            showForecast(cityCode, forecast, ForecastDiff::compute(mForecast.data(), *forecast));
+        }
+        else
+        {
+            parseWeatherJsonDataNew(cachedData);
+        }
+        return;
+    }
+
+    // 离线模式下不发起任何网络请求
+    if(mOffline)
+    {
+        qDebug() << "离线模式，跳过天气请求:" << cityCode;
+        return;
+    }
+
+    // 根据最新配置构建请求URL，城市代码为空时请求服务器默认城市
+    strUrl = getApiUrl(cityCode);
+    QNetworkRequest request((QUrl(strUrl)));
+    request.setAttribute(kCityCodeAttribute, cityCode);
+    request.setAttribute(kApiVersionAttribute, mApiVersion);
+    reply = manager->get(request);
+}
+
+void Widget::prefetchTopCities()
+{
+    if(mOffline)
+    {
+        return;
+    }
+
+    int maxAge = mConfigManager->snapshot()->cacheTtlSeconds;
+    const QVector<SearchHistoryEntry> entries = mSearchHistory->topEntries(kPrefetchCityCount);
+    for(const SearchHistoryEntry &entry : entries)
+    {
+        // 当前城市和缓存未过期的城市不需要预取
+        if(entry.code == mCurrentCityCode || mForecastCache.isFresh(entry.code, maxAge))
+        {
+            continue;
+        }
+        QNetworkRequest request((QUrl(getApiUrl(entry.code))));
+        request.setAttribute(kCityCodeAttribute, entry.code);
+        request.setAttribute(kPrefetchAttribute, true);
+        request.setAttribute(kApiVersionAttribute, mApiVersion);
+        manager->get(request);
+    }
+}
+
+void Widget::applyStartupOptions(const StartupOptions &options, bool initialLaunch)
+{
+    // 转发的--offline把已运行的实例切换到离线模式并停止定时刷新；
+    // 没有对应的参数能退出离线模式，只能重新启动程序
+    if(options.offline && !mOffline)
+    {
+        mOffline = true;
+        applyRefreshConfig(*mConfigManager->snapshot());
+        qDebug() << "已切换到离线模式";
+    }
+
+    // --no-fetch时不请求天气：指定的城市名称只填入搜索框，城市代码忽略
+    if(options.noFetch)
+    {
+        if(!options.cityName.isEmpty())
+        {
+            ui->lineEditCity->setText(options.cityName);
+        }
+        return;
+    }
+
+    if(!options.cityCode.isEmpty())
+    {
+        // 直接按城市代码请求，无需加载城市索引
+        requestWeather(options.cityCode);
+    }
+    else if(!options.cityName.isEmpty())
+    {
+        ui->lineEditCity->setText(options.cityName);
+        QString cityCode = mCityIndex->snapshot()->getCityCodeFromName(options.cityName);
+        if(!cityCode.isEmpty())
+        {
+            requestWeather(cityCode);
+        }
+        else if(initialLaunch)
+        {
+            // 启动参数中的城市无效时退回到默认城市，不在启动时弹窗
+            qWarning() << "未找到启动参数指定的城市:" << options.cityName;
+            requestWeather(QString());
+        }
+        else
+        {
+            searchCity(options.cityName);
+        }
+    }
+    else if(initialLaunch)
+    {
+        // 未指定城市时请求服务器默认城市的天气
+        requestWeather(QString());
+    }
 }
 
 bool Widget::validateCityName(const QString &cityName)
@@ -305,15 +619,18 @@ bool Widget::validateCityName(const QString &cityName)
     }
     
     // 检查是否包含无效字符
-    // 只允许中文字符、英文字母、数字，不允许特殊符号和空格
-    QRegularExpression validPattern("^[\u4e00-\u9fa5a-zA-Z0-9]+$");
+    // 允许中文字符、英文字母（含全角）、数字，以及英文名中间的空格、连字符、撇号和点，
+    // 如"Hong Kong"、"Xi'an"，这些分隔符在查询时由城市索引去掉
+    QRegularExpression validPattern("^[\u4e00-\u9fa5a-zA-Z0-9\uff10-\uff19\uff21-\uff3a\uff41-\uff5a]"
+                                    "([\u4e00-\u9fa5a-zA-Z0-9\uff10-\uff19\uff21-\uff3a\uff41-\uff5a \u3000.'-]*"
+                                    "[\u4e00-\u9fa5a-zA-Z0-9\uff10-\uff19\uff21-\uff3a\uff41-\uff5a.])?$");
     if(!validPattern.match(cityName).hasMatch())
     {
         return false;
     }
     
     // 检查是否全为数字（城市名不应该全为数字）
-    QRegularExpression allDigitsPattern("^[0-9]+$");
+    QRegularExpression allDigitsPattern("^[0-9\uff10-\uff19]+$");
     if(allDigitsPattern.match(cityName).hasMatch())
     {
         return false;
@@ -324,119 +641,234 @@ bool Widget::validateCityName(const QString &cityName)
 
 void Widget::parseWeatherJsonDataNew(QByteArray rawData)
 {
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(rawData);
-    if(!jsonDoc.isNull() && jsonDoc.isObject())
+    // 缓存在API版本切换时清空，其中的数据总是当前版本的格式
+    ForecastError error = ForecastOk;
+    QSharedPointer<LazyForecast> forecast = scanForecast(rawData, mApiVersion, &error);
+    if(!forecast)
+    {
+        qWarning() << "缓存的天气数据无效，忽略:" << ForecastParser::errorName(error);
+        return;
+    }
+
+    publishForecast(mCurrentCityCode, forecast);
+}
+
+QSharedPointer<LazyForecast> Widget::scanForecast(const QByteArray &rawData, const QString &apiVersion,
+                                                  ForecastError *error, QString *serverMessage)
+{
+    // API版本在配置校验时已确认受支持，找不到格式只可能来自异常的请求属性
+    const ForecastSchema *schema = ForecastSchema::find(apiVersion);
+    if(!schema)
+    {
+        *error = ForecastUnknownVersion;
+        return QSharedPointer<LazyForecast>();
+    }
+    return LazyForecast::fromReply(rawData, *schema, error, serverMessage);
+}
+
+ForecastSnapshot Widget::parseForecast(const QByteArray &rawData, const QString &apiVersion,
+                                      ForecastError *error, QString *serverMessage)
+{
+    QSharedPointer<LazyForecast> forecast = scanForecast(rawData, apiVersion, error, serverMessage);
+    if(!forecast)
+    {
+        return ForecastSnapshot();
+    }
+
+    // 发布前一次性解码，之后任何持有者都只读取快照
+    return ForecastRecord::fromForecast(forecast);
+}
+
+void Widget::prunePendingForecasts()
+{
+    // 每一项都与缓存中的原始数据对应，缓存已淘汰的城市不会再命中，扫描结果随之丢弃，
+    // 因此数量不超过缓存上限
+    if(mPendingForecasts.size() <= ForecastCache::kMaxEntries)
+    {
+        return;
+    }
+    for(QHash<QString,QSharedPointer<LazyForecast>>::iterator it = mPendingForecasts.begin();
+        it != mPendingForecasts.end();)
     {
-        QJsonObject jsonRoot = jsonDoc.object();
-        days[0].mCity = jsonRoot["city"].toString();
-        days[0].mPm25 = jsonRoot["aqi"].toObject()["pm25"].toString();
-        if(jsonRoot.contains("data") && jsonRoot["data"].isArray())
+        if(mForecastCache.isFresh(it.key(), -1))
         {
-            QJsonArray weaArray = jsonRoot["data"].toArray();
-            for(int i = 0;i < weaArray.size();i++)
-            {
-                QJsonObject obj = weaArray[i].toObject();
-                //qDebug()<<obj["date"].toString()<<obj["wea"].toString();
-                days[i].mDate = obj["date"].toString();
-                days[i].mWeek = obj["week"].toString();
-                days[i].mWeathType = obj["wea"].toString();
-                days[i].mTemp = obj["tem"].toString();
-                days[i].mTempLow = obj["tem2"].toString();
-                days[i].mTempHigh = obj["tem1"].toString();
-                days[i].mFx = obj["win"].toArray()[0].toString();
-                days[i].mFl = obj["win_speed"].toString();
-                days[i].mAirq = obj["air_level"].toString();
-                days[i].mTips = obj["index"].toArray()[3].toObject()["desc"].toString();
-                days[i].mHu = obj["humidity"].toString();
-            }
-            updateUI();
+            ++it;
+        }
+        else
+        {
+            it = mPendingForecasts.erase(it);
         }
     }
 }
 
-void Widget::updateUI()
+void Widget::publishForecast(const QString &cityCode, const QSharedPointer<LazyForecast> &forecast)
+{
+    // 一次性解码为快照后发布，只更新与该城市上一份数据相比有变化的部分
+    ForecastSnapshot record = ForecastRecord::fromForecast(forecast);
+    ForecastDiff diff = mForecastStore->publish(cityCode, record);
+    showForecast(cityCode, record, diff);
+}
+
+void Widget::showForecast(const QString &cityCode, const ForecastSnapshot &forecast, const ForecastDiff &diff)
+{
+    // 增量是相对于该城市上一份数据计算的，界面显示的是另一个城市时全部更新
+    ForecastDiff changes = cityCode == mForecastCityCode ? diff : ForecastDiff::full();
+    if(changes.isEmpty())
+    {
+        // 数据没有变化，界面、温度曲线和当天实况都保持不变，新快照随之释放
+        return;
+    }
+
+    // 替换快照，没有其他持有者时旧数据及其内存池随之一次性释放；
+    // 响应中缺少的天数为空文字。完整预报比之前的当天实况更新，当天实况不再使用
+    mForecast = forecast;
+    mForecastCityCode = cityCode;
+    bool hadCurrentConditions = !mCurrentConditions.isNull();
+    mCurrentConditions.clear();
+    updateUI(changes);
+    if(hadCurrentConditions)
+    {
+        updateCurrentConditions();
+    }
+}
+
+void Widget::applyCurrentConditions(const QString &cityCode, const QString &apiVersion, const QByteArray &rawData)
+{
+    // 用户已切换城市时丢弃
+    if(cityCode != mCurrentCityCode)
+    {
+        return;
+    }
+    ForecastError error = ForecastOk;
+    QString serverMessage;
+    ForecastSnapshot current = parseForecast(rawData, apiVersion, &error, &serverMessage);
+    if(!current)
+    {
+        qWarning() << "当天实况数据无效，忽略本次响应:" << cityCode
+                   << ForecastParser::errorName(error) << serverMessage;
+        return;
+    }
+
+    // 只更新主面板的三个标签，其余界面和温度曲线保持不变
+    mCurrentConditions = current;
+    updateCurrentConditions();
+}
+
+void Widget::updateCurrentConditions()
+{
+    const Day &current = (mCurrentConditions ? mCurrentConditions : mForecast)->day(0);
+    ui->labelTmp->setText(current.mTemp.toString()+"℃");
+    ui->labelPM25Data->setText(current.mPm25.toString());
+    ui->labelShiDuData->setText(current.mHu.toString());
+}
+
+void Widget::updateUI(const ForecastDiff &diff)
 {
     QPixmap pixmap;
-    //解析日期
-    ui->labelCurrentDate->setText(days[0].mDate+"  "+days[0].mWeek);
+    const Day &first = mForecast->day(0);
+    //日期和星期，星期由日序号推算
+    if(diff.contains(0, FieldDate))
+    {
+        qint32 firstDay = first.mDayNumber;
+        ui->labelCurrentDate->setText(ForecastDate::formatDate(firstDay)+"  "+ForecastDate::weekdayName(firstDay));
+    }
     //解析城市名称
-    ui->labelCity->setText(days[0].mCity+"市");
-    //解析当前温度
-    ui->labelTmp->setText(days[0].mTemp+"℃");
-    ui->labelTempRange->setText(days[0].mTempLow+"℃"+"~"
-            +days[0].mTempHigh+"℃");
-    //解析天气类型
-    ui->labelWeatherType->setText(days[0].mWeathType);
-    
-    // 处理主要天气图标，支持"转"字符的天气类型
-    QString mainWeatherType = days[0].mWeathType;
-    int mainIndex = mainWeatherType.indexOf("转");
-    if(mainIndex != -1)
+    if(diff.contains(0, FieldCity))
     {
-        // 如果包含"转"字符，取"转"字后面的天气类型
-        mainWeatherType = mainWeatherType.right(mainWeatherType.length() - mainIndex - 1);
+        ui->labelCity->setText(first.mCity.toString()+"市");
+    }
+    //当前温度、PM2.5和湿度，有更新的当天实况时使用当天实况
+    if(diff.contains(0, FieldTemp) || diff.contains(0, FieldPm25) || diff.contains(0, FieldHumidity))
+    {
+        updateCurrentConditions();
+    }
+    if(diff.contains(0, FieldTempLow) || diff.contains(0, FieldTempHigh))
+    {
+        ui->labelTempRange->setText(first.mTempLow.toString()+"℃"+"~"
+                +first.mTempHigh.toString()+"℃");
+    }
+    //解析天气类型，主要天气图标的天气类型ID在解析时已确定（含"转"字的类型已处理）
+    if(diff.contains(0, FieldWeatherType))
+    {
+        ui->labelWeatherType->setText(first.mWeathType.toString());
+        ui->labelWeatherIcon->setPixmap(QString(WeatherTables::weatherTypeIcon(first.mWeatherTypeId)));
     }
-    ui->labelWeatherIcon->setPixmap(mTypeMap.value(mainWeatherType, mTypeMap["undefined"]));
     //感冒指数
-    ui->labelGanbao->setText(days[0].mTips);
+    if(diff.contains(0, FieldTips))
+    {
+        ui->labelGanbao->setText(first.mTips.toString());
+    }
     //风向
-    ui->labelFXType->setText(days[0].mFx);
+    if(diff.contains(0, FieldWindDirection))
+    {
+        ui->labelFXType->setText(first.mFx.toString());
+    }
     //风力
-    ui->labelFXData->setText(days[0].mFl);
-    //PM2.5
-    ui->labelPM25Data->setText(days[0].mPm25);
-    //湿度
-    ui->labelShiDuData->setText(days[0].mHu);
+    if(diff.contains(0, FieldWindSpeed))
+    {
+        ui->labelFXData->setText(first.mFl.toString());
+    }
     //空气质量
-    ui->labelAirQualityData->setText(days[0].mAirq);
+    if(diff.contains(0, FieldAirQuality))
+    {
+        ui->labelAirQualityData->setText(first.mAirq.toString());
+    }
 
+    qint32 today = ForecastDate::today();
     for(int i=0 ;i < 6;i++)
     {
-        mWeekList[i]->setText(days[i].mWeek);
-        mWeekList[0]->setText("今天");
-        mWeekList[1]->setText("明天");
-        mWeekList[2]->setText("后天");
-        QStringList dayList = days[i].mDate.split("-");
-        mDateList[i]->setText(dayList.at(1)+"-"+dayList.at(2));
+        // 没有变化的一天不做任何处理
+        if(!diff.containsDay(i))
+        {
+            continue;
+        }
 
-        // 处理天气类型转换（如"晴转多云"）
-        int index = days[i].mWeathType.indexOf("转");
-        if(index != -1)
+        // 今天、明天、后天按本地日期推算，其余显示星期；响应中缺少的天数只显示空白
+        const Day &day = mForecast->day(i);
+        if(diff.contains(i, FieldDate))
         {
-            // 如果包含"转"字符，取"转"字后面的天气类型
-            QString weatherAfterTransition = days[i].mWeathType.right(days[i].mWeathType.length() - index - 1);
-            pixmap = mTypeMap.value(weatherAfterTransition, mTypeMap["undefined"]);
+            qint32 dayNumber = day.mDayNumber;
+            mWeekList[i]->setText(ForecastDate::relativeName(dayNumber, today));
+            mDateList[i]->setText(ForecastDate::formatMonthDay(dayNumber));
         }
-        else
+
+        if(diff.contains(i, FieldWeatherType))
         {
-            // 如果不包含"转"字符，直接使用天气类型
-            pixmap = mTypeMap.value(days[i].mWeathType, mTypeMap["undefined"]);
+            // 按天气类型ID直接索引图标表（"晴转多云"等类型在解析时已处理）
+            pixmap = QPixmap(QString(WeatherTables::weatherTypeIcon(day.mWeatherTypeId)));
+
+            // 缩放图标并设置到UI控件
+            pixmap = pixmap.scaled(mIconList[i]->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+            mIconList[i]->setMaximumSize(78, 62);
+            mIconList[i]->setPixmap(pixmap);
+            mWeaTypeList[i]->setText(day.mWeathType.toString());
         }
-        
-        // 缩放图标并设置到UI控件
-        pixmap = pixmap.scaled(mIconList[i]->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        mIconList[i]->setMaximumSize(78, 62);
-        mIconList[i]->setPixmap(pixmap);
-        mWeaTypeList[i]->setText(days[i].mWeathType);
-
-        // 设置空气质量文本和样式
-        QString airQ = days[i].mAirq;
-        mAirqList[i]->setText(airQ);
-        
-        // 使用映射表统一设置空气质量样式，避免重复代码
-        if(mAirQualityStyleMap.contains(airQ))
+
+        // 设置空气质量文本和样式，未知等级由查找表返回默认样式
+        if(diff.contains(i, FieldAirQuality))
         {
-            mAirqList[i]->setStyleSheet(mAirQualityStyleMap[airQ]);
+            mAirqList[i]->setText(day.mAirq.toString());
+            mAirqList[i]->setStyleSheet(WeatherTables::airQualityStyle(day.mAirqId));
         }
-        else
+        if(diff.contains(i, FieldWindDirection))
         {
-            // 默认样式，用于未知的空气质量等级
-            mAirqList[i]->setStyleSheet("background: rgba(128, 128, 128, 0.25);border: 1px solid rgba(128, 128, 128, 0.3);backdrop-filter: blur(6px);border-radius:7px;color:rgba(255,255,255,0.95)");
+            mFxList[i]->setText(day.mFx.toString());
         }
-        mFxList[i]->setText(days[i].mFx);
-        mFlList[i]->setText(days[i].mFl);
+        if(diff.contains(i, FieldWindSpeed))
+        {
+            mFlList[i]->setText(day.mFl.toString());
+        }
+    }
+
+    // 温度曲线按6天的平均值定位，任何一天的温度变化都需要重绘整条曲线
+    if(diff.containsField(FieldTempHigh))
+    {
+        ui->widget0404->update();
+    }
+    if(diff.containsField(FieldTempLow))
+    {
+        ui->widget0405->update();
     }
-    update();
 }
 
 void Widget::drawTempLineHigh()
@@ -452,7 +884,7 @@ void Widget::drawTempLineHigh()
     int middle = ui->widget0404->height()/2;
     for(int i = 0;i < 6;i++)
     {
-        sum += days[i].mTempHigh.toInt();
+        sum += mForecast->day(i).mTempHighValue;
     }
     ave = sum/6;
 
@@ -460,12 +892,12 @@ void Widget::drawTempLineHigh()
     for(int i = 0;i < 6;i++)
     {
         points[i].setX(mAirqList[i]->x()+mAirqList[i]->width()/2);
-        offSet = (days[i].mTempHigh.toInt()-ave)*3;
+        offSet = (mForecast->day(i).mTempHighValue-ave)*3;
         points[i].setY(middle-offSet);
 
         painter.drawEllipse(QPoint(points[i]),3,3);
 
-        painter.drawText(points[i].x()-10,points[i].y()-10,days[i].mTempHigh+"°");
+        painter.drawText(points[i].x()-10,points[i].y()-10,mForecast->day(i).mTempHigh.toString()+"°");
     }
     for(int i = 0;i < 5;i++)
     {
@@ -487,7 +919,7 @@ void Widget::drawTempLineLow()
     int middle = ui->widget0405->height()/2;
     for(int i = 0;i < 6;i++)
     {
-        sum += days[i].mTempLow.toInt();
+        sum += mForecast->day(i).mTempLowValue;
     }
     ave = sum/6;
 
@@ -495,12 +927,12 @@ void Widget::drawTempLineLow()
     for(int i = 0;i < 6;i++)
     {
         points[i].setX(mAirqList[i]->x()+mAirqList[i]->width()/2);
-        offSet = (days[i].mTempLow.toInt()-ave)*3;
+        offSet = (mForecast->day(i).mTempLowValue-ave)*3;
         points[i].setY(middle-offSet);
 
         painter.drawEllipse(QPoint(points[i]),3,3);
 
-        painter.drawText(points[i].x()-10,points[i].y()-10,days[i].mTempLow+"°");
+        painter.drawText(points[i].x()-10,points[i].y()-10,mForecast->day(i).mTempLow.toString()+"°");
     }
     for(int i = 0;i < 5;i++)
     {
@@ -520,24 +952,91 @@ void Widget::drawTempLineLow()
  */
 void Widget::readHttpReply(QNetworkReply *reply)
 {
+    // 响应对象在事件循环返回后释放
+    reply->deleteLater();
+
     // 获取HTTP响应状态码（200=成功，404=未找到，500=服务器错误等）
     int resCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
 
     // 输出状态码到调试控制台，便于开发调试
     qDebug()<<resCode;
 
+    // 取出请求时附带的城市代码和预取标记
+    QString cityCode = reply->request().attribute(kCityCodeAttribute).toString();
+    bool prefetch = reply->request().attribute(kPrefetchAttribute).toBool();
+    bool currentOnly = reply->request().attribute(kCurrentOnlyAttribute).toBool();
+    QString apiVersion = reply->request().attribute(kApiVersionAttribute).toString();
+
     // 检查网络请求是否成功：无网络错误且HTTP状态码为200
     if(reply->error() == QNetworkReply::NoError && resCode == 200)
     {
         // 一次性读取服务器返回的全部JSON数据
         QByteArray data = reply->readAll();
 
-        // 调用JSON数据解析函数处理天气数据
-        parseWeatherJsonDataNew(data);
+        // 当天实况的响应不是完整预报，不写入缓存，只更新主面板
+        if(currentOnly)
+        {
+            applyCurrentConditions(cityCode, apiVersion, data);
+            return;
+        }
+
+        // 配置切换API版本前发出的请求，其响应不能和新版本的数据混在缓存中
+        if(apiVersion != mApiVersion)
+        {
+            qDebug() << "丢弃旧API版本的响应:" << cityCode << apiVersion;
+            return;
+        }
+
+        // 按请求时的API版本扫描，无效的响应不写入缓存、不发布也不显示
+        ForecastError error = ForecastOk;
+        QString serverMessage;
+        QSharedPointer<LazyForecast> forecast = scanForecast(data, apiVersion, &error, &serverMessage);
+        if(!forecast)
+        {
+            qWarning() << "天气数据无效，忽略本次响应:" << cityCode
+                       << ForecastParser::errorName(error) << serverMessage
+                       << "累计" << ForecastParser::errorCount(error) << "次";
+
+            // 用户正在等待的请求收到服务器的错误对象时提示原因，如appid无效或次数用尽
+            if(error == ForecastApiError && !prefetch && cityCode == mCurrentCityCode)
+            {
+                QMessageBox mes;
+                mes.setWindowTitle("天气服务错误");
+                mes.setText(serverMessage.isEmpty() ? QString("天气服务返回了错误") : serverMessage);
+                mes.setStyleSheet("QPushButton {color: #FF6B6B; background: rgba(255, 107, 107, 0.1); border: 1px solid rgba(255, 107, 107, 0.3); border-radius: 6px; padding: 8px 16px;} QPushButton:hover {background: rgba(255, 107, 107, 0.2);}");
+                mes.setStandardButtons(QMessageBox::Ok);
+                mes.exec();
+            }
+            return;
+        }
+
+        // 写入缓存，之后再查询该城市时无需访问网络
+        mForecastCache.insert(cityCode, data);
+
+        // 预取的数据和用户已切换走的城市的响应只保留扫描结果，不解码、不发布也不更新界面，
+        // 用户切换到该城市时再解码
+        if(prefetch || cityCode != mCurrentCityCode)
+        {
+            if(!cityCode.isEmpty())
+            {
+                mPendingForecasts.insert(cityCode, forecast);
+                prunePendingForecasts();
+            }
+            return;
+        }
+
+        // 当前城市的新响应取代尚未显示的预取数据
+        mPendingForecasts.remove(cityCode);
+        publishForecast(cityCode, forecast);
 
         // 调试用：打印原始JSON数据（已注释）
         // qDebug() << QString::fromUtf8(data);
     }
+    else if(prefetch || currentOnly)
+    {
+        // 后台预取和定时刷新失败不打扰用户，下一次刷新时重试
+        qDebug() << "后台天气请求失败:" << cityCode << reply->errorString();
+    }
     else
     {
         // 处理网络请求失败的情况，提供详细的错误信息
@@ -672,36 +1171,73 @@ void Widget::readHttpReply(QNetworkReply *reply)
     }
 }
 
+void Widget::handleInstanceMessage(const QStringList &arguments)
+{
+    // 把已运行的窗口带到前台
+    showNormal();
+    raise();
+    activateWindow();
+
+    // 使用与首次启动相同的规则解析转发的参数
+    StartupOptions options;
+    QString errorMessage;
+    if(!StartupOptions::parse(arguments, &options, &errorMessage))
+    {
+        qWarning() << "无法解析转发的启动参数:" << errorMessage;
+        return;
+    }
+    applyStartupOptions(options, false);
+}
+
 void Widget::on_LineEditCity_clicked()
 {
-    // 从UI的lineEditCity控件中获取用户输入的城市名称
-    QString cityNameFromUser = ui->lineEditCity->text().trimmed();
+    // 直接搜索时不再需要补全列表，尚未返回的补全结果也一并作废
+    mSearchDispatcher->cancel();
+    mSuggestionCompleter->popup()->hide();
 
+    // 从UI的lineEditCity控件中获取用户输入的城市名称并查询
+    searchCity(ui->lineEditCity->text().trimmed());
+}
+
+void Widget::searchCity(const QString &cityNameFromUser)
+{
     // 验证城市名称输入的有效性
     if(!validateCityName(cityNameFromUser))
     {
         // 显示输入验证错误信息
         QMessageBox mes;
         mes.setWindowTitle("输入错误");
-        mes.setText("请输入有效的城市名称：\n- 长度在1-20个字符之间\n- 只能包含中文、英文字母和数字\n- 不能全为数字或包含特殊符号");
+        mes.setText("请输入有效的城市名称：\n- 长度在1-20个字符之间\n- 只能包含中文、英文字母、数字及英文名中的空格、连字符、撇号\n- 不能全为数字或包含特殊符号");
         mes.setStyleSheet("QPushButton {color: #FF6B6B; background: rgba(255, 107, 107, 0.1); border: 1px solid rgba(255, 107, 107, 0.3); border-radius: 6px; padding: 8px 16px;} QPushButton:hover {background: rgba(255, 107, 107, 0.2);}");
         mes.setStandardButtons(QMessageBox::Ok);
         mes.exec();
         return;
     }
 
-    // 调用自定义函数，根据用户输入的城市名称获取对应的城市编码
-    QString cityCode = cityCodeUtils.getCityCodeFromName(cityNameFromUser);
+    // 先在搜索历史中召回，命中时无需查询城市索引
+    QString historyCode = mSearchHistory->recall(cityNameFromUser);
+    if(!historyCode.isEmpty())
+    {
+        requestWeather(historyCode);
+        recordSearch(cityNameFromUser, historyCode);
+        return;
+    }
+
+    // 根据用户输入的城市名称获取候选城市，候选列表已按排名排序
+    QVector<CityCandidate> candidates = mCityIndex->snapshot()->getCityCandidates(cityNameFromUser);
 
-    // 检查是否成功获取到城市编码（不为空字符串）
-    // 使用isEmpty()方法进行正确的字符串空值判断
-    if(!cityCode.isEmpty())
+    // 检查是否找到了城市
+    if(!candidates.isEmpty())
     {
-        // 将城市编码拼接到底层URL字符串中，形成完整请求参数
-        strUrl += "&cityid="+cityCode;
+        // 直接请求排名最高的城市，根据最新配置构建完整请求URL并发送GET请求
+        requestWeather(candidates.first().code);
+        recordSearch(cityNameFromUser, candidates.first().code);
 
-        // 通过网络管理器发送GET请求，请求地址为拼接后的完整URL
-        manager->get(QNetworkRequest(QUrl(strUrl)));
+        // 存在同名城市时，在搜索框下方列出其他候选城市供用户切换
+        if(candidates.size() > 1)
+        {
+            showCityAlternates(cityNameFromUser, candidates);
+        }
     }
     else
     {
@@ -720,6 +1256,40 @@ void Widget::on_LineEditCity_clicked()
     }
 }
 
+void Widget::recordSearch(const QString &cityName, const QString &cityCode)
+{
+    mSearchHistory->record(cityName, cityCode);
+}
+
+void Widget::showCityAlternates(const QString &cityName, const QVector<CityCandidate> &candidates)
+{
+    // 候选菜单只创建一次，每次搜索时重新填充
+    if(!mAlternatesMenu)
+    {
+        mAlternatesMenu = new QMenu(this);
+        mAlternatesMenu->setStyleSheet(menuQuit->styleSheet());
+        connect(mAlternatesMenu, &QMenu::triggered, this, [this](QAction *action){
+            QString code = action->data().toString();
+            requestWeather(code);
+            // 用户的选择写入搜索历史，下次输入同一名称时直接召回该城市
+            recordSearch(mAlternatesMenu->property("cityName").toString(), code);
+        });
+    }
+    mAlternatesMenu->clear();
+    mAlternatesMenu->setProperty("cityName", cityName);
+
+    QAction *title = mAlternatesMenu->addAction(QString("当前：%1").arg(candidates.first().displayName()));
+    title->setEnabled(false);
+    for(int i = 1; i < candidates.size(); i++)
+    {
+        QAction *action = mAlternatesMenu->addAction(candidates[i].displayName());
+        action->setData(candidates[i].code);
+    }
+
+    // 非模态弹出，不阻塞已经发出的天气请求
+    mAlternatesMenu->popup(ui->lineEditCity->mapToGlobal(QPoint(0, ui->lineEditCity->height())));
+}
+
 void Widget::on_lineEditCity_returnPressed()
 {
     on_LineEditCity_clicked();
@@ -22,14 +22,27 @@
 #include <QDebug>                   // 调试输出
 #include <QLabel>                   // 标签控件
 #include <QList>                    // Qt列表容器
+#include <QHash>                    // 尚未解码的天气数据
+#include <QStandardItemModel>       // 自动补全候选列表模型
+#include <QFutureWatcher>           // 监视后台补全查询
+#include <QFutureSynchronizer>      // 等待全部后台补全查询结束
 
 // 自定义类头文件
-#include "citycodeutils.h"          // 城市代码工具类
-#include "day.h"                    // 天气数据结构类
+#include "appconfig.h"              // 配置子系统
+#include "cityindexmanager.h"       // 城市索引管理类
+#include "forecastcache.h"          // 天气数据缓存
+#include "forecastdiff.h"           // 天气数据的字段级增量
+#include "forecastrecord.h"         // 不可变的天气数据快照
+#include "forecaststore.h"          // 按城市保存的天气数据快照
+#include "searchdispatcher.h"       // 搜索框输入分发
+#include "searchhistory.h"          // 城市搜索历史
+#include "startupoptions.h"         // 启动参数
 
 // Qt UI命名空间声明
 QT_BEGIN_NAMESPACE
 namespace Ui { class Widget; }
+class QCompleter;
+class QTimer;
 QT_END_NAMESPACE
 
 /**
@@ -49,8 +62,12 @@ class Widget : public QWidget
     Q_OBJECT
 
 public:
-    // 天气数据存储数组，存储7天的天气信息
-    Day days[7];
+    // 当前显示的天气数据快照，不可变，界面和温度曲线只读取
+    ForecastSnapshot mForecast;
+
+    // 分级刷新得到的当天实况，比mForecast新时覆盖主面板的温度、湿度和PM2.5；
+    // 收到新的完整预报后清空
+    ForecastSnapshot mCurrentConditions;
     
     // UI控件列表，用于批量管理界面元素
     QList<QLabel *> mDateList;      // 日期标签列表
@@ -63,12 +80,13 @@ public:
 
     /**
      * @brief 构造函数
+     * @param options 启动参数，决定首个天气请求的目标城市
      * @param parent 父窗口指针，默认为nullptr
      * 
      * 初始化主窗口，设置UI界面，建立网络连接，
      * 配置各种控件和事件处理器。
      */
-    Widget(QWidget *parent = nullptr);
+    explicit Widget(const StartupOptions &options = StartupOptions(), QWidget *parent = nullptr);
     
     /**
      * @brief 析构函数
@@ -120,6 +138,15 @@ public slots:
      */
     void readHttpReply(QNetworkReply *reply);
 
+    /**
+     * @brief 处理其他启动进程转发的参数
+     * @param arguments 转发的完整命令行参数（第一项为程序名）
+     * 
+     * 重复启动程序时由单实例守护调用：激活当前窗口，
+     * 如果参数中指定了城市则直接查询该城市的天气。
+     */
+    void handleInstanceMessage(const QStringList &arguments);
+
 private slots:
     /**
      * @brief 城市搜索按钮点击槽函数
@@ -137,6 +164,57 @@ private slots:
      */
     void on_lineEditCity_returnPressed();
 
+    /**
+     * @brief 配置热加载槽函数
+     * @param config 新的配置快照
+     *
+     * 配置文件被修改并通过校验后调用，使用新配置重新请求当前城市的天气，
+     * 使新的API密钥或基础URL立即生效；API版本改变时清空按旧格式缓存的数据。
+     */
+    void onConfigChanged(AppConfigSnapshot config);
+
+    /**
+     * @brief 搜索历史加载完成槽函数
+     * 
+     * 在后台预取常用城市的天气数据。
+     */
+    void onHistoryLoaded();
+
+    /**
+     * @brief 搜索框输入稳定后的实时查询
+     * @param text 输入文字
+     * @param generation 查询代号，结果返回时用于判断是否过期
+     * 
+     * 在后台线程按前缀查询城市索引，不阻塞输入。
+     */
+    void onSearchQuery(const QString &text, quint64 generation);
+
+    /**
+     * @brief 后台补全查询完成，结果未过期时显示补全列表
+     */
+    void onSuggestionsReady();
+
+    /**
+     * @brief 用户选择了一个补全候选
+     * @param index 候选在补全列表中的位置
+     * 
+     * 按候选携带的城市代码直接请求天气，同名城市不会被混淆。
+     */
+    void onSuggestionActivated(const QModelIndex &index);
+
+    /**
+     * @brief 完整预报的定时刷新
+     *
+     * 不使用缓存重新请求当前城市的完整预报，完整预报同样包含当天实况，
+     * 因此同时推迟下一次当天实况的刷新。
+     */
+    void onForecastRefresh();
+
+    /**
+     * @brief 当天实况的定时刷新（tiered模式）
+     */
+    void onCurrentRefresh();
+
 private:
     // UI界面相关成员变量
     Ui::Widget *ui;                     // UI界面对象指针
@@ -149,22 +227,28 @@ private:
     QNetworkAccessManager *manager;     // 网络访问管理器
     
     // 数据处理相关成员变量
-    CityCodeUtils cityCodeUtils;        // 城市代码工具类实例
-    QMap<QString,QString> mTypeMap;     // 天气类型到图标路径的映射表
-    
-    /**
-     * @brief 空气质量等级到样式的映射表
-     * 
-     * 存储不同空气质量等级对应的CSS样式字符串，用于统一管理空气质量显示样式。
-     * 键为空气质量等级字符串（如"优"、"良"等），值为对应的样式字符串。
-     */
-    QMap<QString,QString> mAirQualityStyleMap;
+    CityIndexManager *mCityIndex;       // 城市索引管理器，提供可增量更新的城市索引快照
     
     // 配置相关成员变量
-    QString mApiAppId;      // API应用ID
-    QString mApiAppSecret;  // API密钥
-    QString mApiBaseUrl;    // API基础URL
-    QString mApiVersion;    // API版本
+    ConfigManager *mConfigManager;  // 配置管理器，提供可热加载的配置快照
+    QString mCurrentCityCode;       // 当前显示城市的代码，为空表示服务器默认城市
+    QString mApiVersion;            // 缓存中的数据使用的API版本，决定响应的解析格式
+    bool mOffline;                  // 离线模式，不发起网络请求
+    QTimer *mForecastTimer;         // 完整预报的刷新定时器
+    QTimer *mCurrentTimer;          // 当天实况的刷新定时器，只在tiered模式下运行
+    QMenu *mAlternatesMenu;         // 同名候选城市菜单，首次使用时创建
+    SearchHistory *mSearchHistory;  // 持久化的城市搜索历史
+    SearchDispatcher *mSearchDispatcher;    // 搜索框输入分发，过滤输入法组字并防抖
+    QCompleter *mSuggestionCompleter;       // 搜索框自动补全弹出列表
+    QStandardItemModel *mSuggestionModel;   // 补全候选：历史记录和城市索引的前缀匹配
+    QFutureWatcher<QVector<CityCandidate>> mSuggestionWatcher; // 后台补全查询监视器
+    QFutureSynchronizer<QVector<CityCandidate>> mSuggestionLookups; // 尚未结束的全部补全查询，包括已被替换的
+    quint64 mSuggestionGeneration;  // 正在进行的补全查询的代号
+    QString mSuggestionText;        // 正在进行的补全查询的文字
+    ForecastCache mForecastCache;   // 按城市代码缓存的天气数据
+    QHash<QString,QSharedPointer<LazyForecast>> mPendingForecasts; // 预取和非当前城市的响应，只扫描过、尚未解码
+    ForecastStore *mForecastStore;  // 按城市代码发布的天气数据快照和变化通知，可在任意线程读取
+    QString mForecastCityCode;      // mForecast所属城市的代码，决定增量能否直接用于界面
     
     // 私有成员函数声明
     // parseWeatherJsonData函数已删除，请使用parseWeatherJsonDataNew
@@ -176,36 +260,171 @@ private:
      * 
      * 检查城市名称的格式和长度是否符合要求：
      * - 长度在1-20个字符之间
-     * - 只包含中文字符、英文字母和数字
-     * - 不包含特殊符号和空格
+     * - 只包含中文字符、英文字母（含全角）和数字
+     * - 英文名中间可以有空格、连字符、撇号和点，不包含其他特殊符号
      */
     bool validateCityName(const QString &cityName);
     
+    /**
+     * @brief 查询指定城市的天气
+     * @param cityName 城市名称
+     * 
+     * 验证城市名称、查找城市代码并发起天气请求，
+     * 输入无效或城市不存在时弹出错误提示。
+     */
+    void searchCity(const QString &cityName);
+    
+    /**
+     * @brief 请求指定城市的天气数据
+     * @param cityCode 城市代码，为空时请求服务器默认城市
+     * @param useCache 是否允许使用缓存数据，为false时总是发起网络请求
+     * 
+     * 缓存中有未过期的数据时直接显示，不发起网络请求；
+     * 离线模式下允许使用已过期的缓存数据。
+     */
+    void requestWeather(const QString &cityCode, bool useCache = true);
+    
+    /**
+     * @brief 在后台预取搜索历史中排名靠前的城市的天气数据
+     * 
+     * 预取的数据只写入缓存，不更新界面。
+     */
+    void prefetchTopCities();
+    
+    /**
+     * @brief 记录一次成功的城市查询
+     * @param cityName 用户输入的城市名称
+     * @param cityCode 解析得到的城市代码
+     */
+    void recordSearch(const QString &cityName, const QString &cityCode);
+    
+    /**
+     * @brief 显示同名候选城市菜单
+     * @param cityName 用户输入的城市名称
+     * @param candidates 候选城市列表，第一项为当前已请求的城市
+     * 
+     * 在搜索框下方非模态弹出菜单，用户选择其他候选城市时重新请求天气。
+     */
+    void showCityAlternates(const QString &cityName, const QVector<CityCandidate> &candidates);
+    
+    /**
+     * @brief 根据启动参数选择城市并发起请求
+     * @param options 启动参数
+     * @param initialLaunch 是否为程序首次启动，首次启动时未指定城市则请求默认城市
+     */
+    void applyStartupOptions(const StartupOptions &options, bool initialLaunch);
+    
     /**
      * @brief 加载配置文件
      * 
-     * 从配置文件中读取应用程序设置，包括API密钥、默认城市等。
+     * 创建配置管理器，从配置文件中读取应用程序设置，包括API密钥、默认城市等，
+     * 并开始监视配置文件的修改。
      */
     void loadConfig();
     
+    /**
+     * @brief 按配置启动或停止定时刷新
+     * @param config 配置快照
+     *
+     * off模式不刷新；full模式只按间隔刷新完整预报；
+     * tiered模式另外以更短的间隔请求只有当天实况的小响应。
+     */
+    void applyRefreshConfig(const AppConfig &config);
+
+    /**
+     * @brief 请求当前城市的当天实况
+     *
+     * 使用配置中的current_version，响应只用于更新主面板，不写入缓存。
+     */
+    void requestCurrentConditions();
+
     /**
      * @brief 获取天气API的URL
+     * @param cityCode 城市代码，为空时请求服务器默认城市
      * @return 完整的API请求URL字符串
      * 
-     * 根据配置文件中的设置构建天气API请求URL。
+     * 根据当前配置快照构建天气API请求URL。
      */
-    QString getApiUrl();
+    QString getApiUrl(const QString &cityCode = QString());
     
     /**
      * @brief 解析天气JSON数据（新版本）
      * @param rawData 原始JSON字节数据
+     * 
+     * 按当前API版本的响应格式解析为快照，成功后发布并替换mForecast，
+     * 格式错误时保留当前数据。
      */
     void parseWeatherJsonDataNew(QByteArray rawData);
+
+    /**
+     * @brief 按API版本的响应格式解析一次响应
+     * @param rawData 原始响应数据
+     * @param apiVersion 请求使用的API版本
+     * @param error 写入扫描结果
+     * @param serverMessage 不为nullptr且服务器返回错误对象时写入其中的错误信息
+     * @return 不可变的天气数据快照，扫描失败时返回空指针
+     *
+     * 由LazyForecast做一遍结构扫描，成功后一次性解码为ForecastRecord。
+     */
+    ForecastSnapshot parseForecast(const QByteArray &rawData, const QString &apiVersion,
+                                   ForecastError *error, QString *serverMessage = nullptr);
+
+    /**
+     * @brief 按API版本的响应格式扫描一次响应，不解码任何字段
+     * @return 按需解码的天气数据，扫描失败时返回空指针
+     *
+     * 预取和非当前城市的响应只需要确认格式有效，解码留到显示时进行。
+     */
+    QSharedPointer<LazyForecast> scanForecast(const QByteArray &rawData, const QString &apiVersion,
+                                              ForecastError *error, QString *serverMessage = nullptr);
+
+    /**
+     * @brief 解码一份已扫描的完整预报，发布并显示
+     * @param cityCode 数据所属城市的代码
+     * @param forecast 已扫描的天气数据
+     *
+     * 快照只在这里和当天实况处构建，后台预取的数据在被显示前不会解码。
+     */
+    void publishForecast(const QString &cityCode, const QSharedPointer<LazyForecast> &forecast);
+
+    /**
+     * @brief 丢弃缓存中已淘汰的城市的扫描结果
+     */
+    void prunePendingForecasts();
+
+    /**
+     * @brief 显示一份新的完整预报
+     * @param cityCode 数据所属城市的代码
+     * @param forecast 已解析的天气数据快照
+     * @param diff 与该城市上一份数据相比的增量
+     *
+     * 只更新增量中标记的字段，增量为空时不做任何处理；
+     * 界面显示的是另一个城市时忽略增量，全部更新。
+     * 有变化时替换mForecast，旧的当天实况随之失效。
+     */
+    void showForecast(const QString &cityCode, const ForecastSnapshot &forecast, const ForecastDiff &diff);
+
+    /**
+     * @brief 处理当天实况的响应
+     * @param cityCode 请求的城市代码
+     * @param apiVersion 请求使用的API版本
+     * @param rawData 原始响应数据
+     */
+    void applyCurrentConditions(const QString &cityCode, const QString &apiVersion, const QByteArray &rawData);
     
     /**
      * @brief 更新用户界面显示
+     * @param diff 需要更新的字段，只有其中标记的标签被重新设置，
+     *             温度曲线只在温度变化时重绘
+     */
+    void updateUI(const ForecastDiff &diff);
+
+    /**
+     * @brief 只更新主面板上频繁变化的标签（温度、湿度、PM2.5）
+     *
+     * 有当天实况时使用当天实况，否则使用完整预报的第一天。
      */
-    void updateUI();
+    void updateCurrentConditions();
     
     /**
      * @brief 绘制高温曲线图